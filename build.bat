@@ -6,6 +6,9 @@ REM Enable warnings with: /W4 /wd4201
 REM /wd4201 Ignores the compiler warning C4201 about nameless structs/unions
 set cl_default_flags=/Isrc /nologo /FC /Zi 
 
+REM build.bat avx2 builds the AVX2 scan kernels too, the exe then needs a CPU that has AVX2
+if "%1"=="avx2" set cl_default_flags=%cl_default_flags% /arch:AVX2
+
 set external_include= /I"..\src\fz_std" ^
                       /I"..\src\fz_std\extra" ^
                       /I"..\src\fz_std\win32" ^
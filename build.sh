@@ -0,0 +1,21 @@
+#!/bin/sh
+# Headless Linux build. Mirrors build.bat.
+# sh build.sh avx2 builds the AVX2 scan kernels too, the binary then needs a CPU that has AVX2.
+
+compiler_and_entry="${CC:-cc} ../src/main.c"
+
+default_flags="-std=gnu11 -g -O2 -DFZ_HEADLESS=1"
+if [ "$1" = "avx2" ]; then
+  default_flags="$default_flags -mavx2"
+fi
+
+external_include="-I../src \
+                  -I../src/fz_std \
+                  -I../src/fz_std/extra \
+                  -I../src/fz_std/linux"
+
+linker_flags="-lpthread -lm"
+
+mkdir -p build
+cd build
+$compiler_and_entry $default_flags $external_include $linker_flags -o fz_sane
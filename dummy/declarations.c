@@ -19,3 +19,7 @@ long double ld;
 void* ptr;
 int* intptr;
 int** intptr2;
+
+// Qualifier macros from headers that are never read
+C_LINKAGE void* memory;
+C_LINKAGE String8 name;
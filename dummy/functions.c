@@ -18,3 +18,12 @@ int factorial(int n) {
   if (n <= 1) return 1;
   return n * factorial(n - 1);
 }
+
+internal void f5(void) {
+  local_persist u32 calls = 0;
+  calls += 1;
+}
+
+internal String8 f6(void);
+
+global u32 counter;
@@ -0,0 +1,391 @@
+///////////////
+// Analysis
+internal Analysis analysis_run(Arena* arena, String8_List paths, u32 worker_count, String8 cache_directory, Analysis_Mode mode) {
+  Analysis result    = {0};
+  intern_init();
+  rules_init();
+  if (mode != Analysis_Mode_Full || (cache_directory.size > 0 && !directory_create(cache_directory))) {
+    cache_directory = (String8){0};
+  }
+
+  result.files       = ArenaPush(arena, Analysis_File, paths.node_count);
+  result.files_count = paths.node_count;
+  result.pool        = thread_pool_init(arena, worker_count);
+
+  Symbol_Index* symbols = NULL;
+  if (mode == Analysis_Mode_Full) {
+    symbols = ArenaPush(arena, Symbol_Index, 1);
+    symbol_index_init(symbols);
+  }
+
+  u64 index = 0;
+  for (String8_Node* node = paths.first; node != NULL; node = node->next, index += 1) {
+    Analysis_File* file = &result.files[index];
+    file->path            = node->value;
+    file->cache_directory = cache_directory;
+    file->mode            = mode;
+    file->symbols         = symbols;
+    thread_pool_push(result.pool, analysis_file_job, file);
+  }
+
+  u64 start = time_now_microseconds();
+  thread_pool_run(result.pool);
+  if (symbols != NULL) {
+    analysis_check_symbols(arena, &result, symbols);
+    symbol_index_release(symbols);
+  }
+  result.elapsed_microseconds = time_now_microseconds() - start;
+
+  analysis_merge(&result);
+  return result;
+}
+
+internal Analysis analysis_run_tree(Arena* arena, String8 root, u32 worker_count, String8 cache_directory, Analysis_Mode mode) {
+  Analysis result = {0};
+  intern_init();
+  rules_init();
+  if (mode != Analysis_Mode_Full || (cache_directory.size > 0 && !directory_create(cache_directory))) {
+    cache_directory = (String8){0};
+  }
+  result.pool = thread_pool_init(arena, worker_count);
+
+  Analysis_Tree* tree   = ArenaPush(arena, Analysis_Tree, 1);
+  tree->cache_directory = cache_directory;
+  tree->mode            = mode;
+  if (mode == Analysis_Mode_Full) {
+    tree->symbols = ArenaPush(arena, Symbol_Index, 1);
+    symbol_index_init(tree->symbols);
+  }
+  tree->found           = ArenaPush(arena, Analysis_File*, result.pool->worker_count);
+  tree->found_counts    = ArenaPush(arena, u64, result.pool->worker_count);
+
+  Analysis_Directory* directory = ArenaPush(arena, Analysis_Directory, 1);
+  directory->tree = tree;
+  directory->path = path_new(arena, root);
+  thread_pool_push(result.pool, analysis_directory_job, directory);
+
+  u64 start = time_now_microseconds();
+  thread_pool_run(result.pool);
+  result.elapsed_microseconds = time_now_microseconds() - start;
+
+  // NOTE(fz): Discovery order depends on scheduling, sorting by path keeps the report deterministic.
+  for (u32 i = 0; i < result.pool->worker_count; i += 1) {
+    result.files_count += tree->found_counts[i];
+  }
+  result.files = ArenaPushNoZero(arena, Analysis_File, result.files_count);
+  u64 index = 0;
+  for (u32 i = 0; i < result.pool->worker_count; i += 1) {
+    for (Analysis_File* file = tree->found[i]; file != NULL; file = file->next) {
+      result.files[index] = *file;
+      index += 1;
+    }
+  }
+  qsort(result.files, result.files_count, sizeof(Analysis_File), analysis_file_compare);
+  for (u64 i = 0; i < result.files_count; i += 1) {
+    result.files[i].next = NULL;
+  }
+  if (tree->symbols != NULL) {
+    analysis_check_symbols(arena, &result, tree->symbols);
+    symbol_index_release(tree->symbols);
+  }
+
+  analysis_merge(&result);
+  return result;
+}
+
+internal void analysis_release(Analysis* analysis) {
+  thread_pool_release(analysis->pool);
+  MemoryZeroStruct(analysis);
+}
+
+internal void analysis_report(Analysis* analysis) {
+  for (u64 i = 0; i < analysis->files_count; i += 1) {
+    Arena_Temp scratch = scratch_begin(0, 0);
+    String8_List lines = {0};
+    analysis_report_file(scratch.arena, &lines, &analysis->files[i]);
+    String8 text = string8_list_join(scratch.arena, &lines);
+    fwrite(text.str, 1, text.size, stdout);
+    scratch_end(&scratch);
+  }
+
+  f64 seconds = (f64)analysis->elapsed_microseconds / 1000000.0;
+  f64 mb      = (f64)analysis->bytes / (f64)Megabytes(1);
+  printf("%llu files (%llu cached), %.2f MB, %llu tokens, %llu diagnostics in %.4f s (%.2f MB/s, %u workers)\n",
+         analysis->files_count, analysis->cached_count, mb, analysis->tokens_count, analysis->diagnostics_count,
+         seconds, (seconds > 0) ? mb / seconds : 0.0, analysis->pool->worker_count);
+}
+
+internal void analysis_report_file(Arena* arena, String8_List* lines, Analysis_File* file) {
+  if (file->is_unreadable) {
+    string8_list_push(arena, lines, string8_format(arena, Str8("%.*s: \x1b[91merror: \x1b[0mFile can't be read\n"),
+                                                   (s32)file->path.size, file->path.str));
+  }
+  for (u32 i = 0; i < file->diagnostics_count; i += 1) {
+    Analysis_Diagnostic* diagnostic = &file->diagnostics[i];
+    String8 arguments[PARSER_ERROR_ARGUMENT_COUNT];
+    for (u32 k = 0; k < PARSER_ERROR_ARGUMENT_COUNT; k += 1) {
+      arguments[k] = file->strings[diagnostic->arguments[k]];
+    }
+
+    // NOTE(fz): Same bytes printf_color writes, the lines may be sent to another terminal instead of printed.
+    if (diagnostic->rule == Rule_None) {
+      String8 message = parser_error_format(arena, diagnostic->code, arguments);
+      string8_list_push(arena, lines, string8_format(arena, Str8("%.*s:%u:%u: \x1b[91merror: \x1b[0m%.*s\n"),
+                                                     (s32)file->path.size, file->path.str, diagnostic->position.line, diagnostic->position.column,
+                                                     (s32)message.size, message.str));
+    } else {
+      String8 message = rule_format(arena, diagnostic->rule, arguments[0]);
+      string8_list_push(arena, lines, string8_format(arena, Str8("%.*s:%u:%u: \x1b[93mwarning: \x1b[0m%.*s [%s]\n"),
+                                                     (s32)file->path.size, file->path.str, diagnostic->position.line, diagnostic->position.column,
+                                                     (s32)message.size, message.str, rule_names[diagnostic->rule]));
+    }
+  }
+}
+
+internal void analysis_file_job(Arena* arena, void* context) {
+  Analysis_File* file = (Analysis_File*)context;
+  Lexer_Flags flags   = Lexer_Flag_Merge_Whitespace | Lexer_Flag_Intern;
+  b32 use_cache       = (file->cache_directory.size > 0);
+
+  if (file->mode == Analysis_Mode_Lint) {
+    // Token rules only read comments, identifiers need no ids
+    Lexer lexer;
+    Token_Array tokens  = load_all_tokens(&lexer, file->path, Lexer_Flag_Merge_Whitespace);
+    file->is_unreadable = !lexer.map.is_readable;
+    file->bytes         = tokens.source.size;
+    file->tokens_count = tokens.count;
+    analyze_file(arena, file, &tokens, NULL);
+    lexer_free(&lexer);
+    return;
+  }
+  if (file->mode == Analysis_Mode_Whitespace) {
+    // An empty token array over the mapped bytes, the rules only look at its source
+    File_Map map        = file_map_open(file->path);
+    Arena* lines_arena  = line_index_arena_init(map.data.size);
+    Token_Array tokens  = {0};
+    tokens.source       = map.data;
+    tokens.lines        = line_index_build(lines_arena, map.data);
+    file->is_unreadable = !map.is_readable;
+    file->bytes         = map.data.size;
+    analyze_file(arena, file, &tokens, NULL);
+    arena_free(lines_arena);
+    file_map_close(&map);
+    return;
+  }
+
+  // NOTE(fz): Modified time is read before mapping, if the file changes in between the entry stored is older than the file, never newer.
+  u64 modified_time = use_cache ? file_get_last_modified_time(file->path) : 0;
+  File_Map map = file_map_open(file->path);
+  if (!map.is_readable) {
+    // Nothing to parse, and nothing that should go into the cache
+    file->is_unreadable = true;
+    return;
+  }
+
+  // NOTE(fz): The worker arena lives until the pool is released, so what only this job reads (the cache path, a hit's
+  // tokens and strings) goes into scratch. analyze_file copies what it keeps into the worker arena.
+  Arena_Temp scratch = scratch_begin(&arena, 1);
+  Cache_Entry entry  = {0};
+  Parser parser      = {0};
+  if (use_cache && cache_load(scratch.arena, file->cache_directory, file->path, map.data, modified_time, flags, &entry, &parser)) {
+    file->is_cached    = true;
+    file->bytes        = parser.tokens.source.size;
+    file->tokens_count = parser.tokens.count;
+    analyze_file(arena, file, &parser.tokens, &parser);
+
+    cache_close(&entry);
+    file_map_close(&map);
+  } else {
+    Lexer lexer;
+    Token_Array tokens = load_all_tokens_from_map(&lexer, map, flags);
+#if DEBUG
+    parser.file = &lexer.file;
+#endif
+    parse_ast(&parser, tokens);
+
+    file->bytes        = tokens.source.size;
+    file->tokens_count = tokens.count;
+    analyze_file(arena, file, &parser.tokens, &parser);
+    if (use_cache) {
+      cache_store(file->cache_directory, file->path, modified_time, flags, &parser);
+    }
+
+    parser_free(&parser);
+    lexer_free(&lexer);
+  }
+  scratch_end(&scratch);
+}
+
+internal void analysis_directory_job(Arena* arena, void* context) {
+  Analysis_Directory* directory = (Analysis_Directory*)context;
+  Analysis_Visit visit = { arena, directory->tree };
+  directory_visit(directory->path, analysis_directory_visit, &visit);
+}
+
+internal void analysis_directory_visit(String8 directory_path, String8 name, b32 is_directory, void* context) {
+  Analysis_Visit* visit = (Analysis_Visit*)context;
+  Analysis_Tree* tree   = visit->tree;
+
+  if (is_directory) {
+    Analysis_Directory* child = ArenaPush(visit->arena, Analysis_Directory, 1);
+    child->tree = tree;
+    child->path = path_join(visit->arena, directory_path, name);
+    thread_pool_push_from_job(analysis_directory_job, child);
+  } else if (analysis_is_source(name)) {
+    // NOTE(fz): Lives in the worker arena until the pool is released, the worker that found it owns its list.
+    u32 worker = thread_pool_worker_index();
+    Analysis_File* file   = ArenaPush(visit->arena, Analysis_File, 1);
+    file->path            = path_join(visit->arena, directory_path, name);
+    file->cache_directory = tree->cache_directory;
+    file->mode            = tree->mode;
+    file->symbols         = tree->symbols;
+    file->next            = tree->found[worker];
+    tree->found[worker]   = file;
+    tree->found_counts[worker] += 1;
+    thread_pool_push_from_job(analysis_file_job, file);
+  }
+}
+
+internal void analysis_merge(Analysis* analysis) {
+  // NOTE(fz): Merge in file order, never in completion order.
+  for (u64 i = 0; i < analysis->files_count; i += 1) {
+    analysis->bytes             += analysis->files[i].bytes;
+    analysis->tokens_count      += analysis->files[i].tokens_count;
+    analysis->diagnostics_count += analysis->files[i].diagnostics_count + analysis->files[i].is_unreadable;
+    analysis->cached_count      += analysis->files[i].is_cached;
+  }
+}
+
+internal void analysis_check_symbols(Arena* arena, Analysis* analysis, Symbol_Index* symbols) {
+  // NOTE(fz): Findings sorted by path, then each file finds its own by binary search. Works for analysis_run's files
+  // in the order they were given as well as for analysis_run_tree's sorted ones.
+  Arena_Temp scratch = scratch_begin(&arena, 1);
+  u64 findings_count = 0;
+  Symbol_Finding* findings = symbols_check(scratch.arena, symbols, &findings_count);
+  qsort(findings, findings_count, sizeof(Symbol_Finding), analysis_finding_compare);
+
+  for (u64 i = 0; i < analysis->files_count && findings_count > 0; i += 1) {
+    Analysis_File* file = &analysis->files[i];
+    u64 low  = 0;
+    u64 high = findings_count;
+    while (low < high) {
+      u64 middle = low + (high - low) / 2;
+      if (string8_compare(findings[middle].path, file->path) < 0) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    u64 end = low;
+    while (end < findings_count && string8_equal(findings[end].path, file->path)) {
+      end += 1;
+    }
+    if (end == low) continue;
+
+    // The file's arrays are exact, both are copied once with room for what was found
+    u32 added = (u32)(end - low);
+    Analysis_Diagnostic* diagnostics = ArenaPushNoZero(arena, Analysis_Diagnostic, file->diagnostics_count + added);
+    String8* strings                 = ArenaPushNoZero(arena, String8, file->strings_count + added);
+    MemoryCopy(diagnostics, file->diagnostics, file->diagnostics_count * sizeof(Analysis_Diagnostic));
+    MemoryCopy(strings, file->strings, file->strings_count * sizeof(String8));
+    for (u32 k = 0; k < added; k += 1) {
+      Symbol_Finding* finding = &findings[low + k];
+      Analysis_Diagnostic* diagnostic = &diagnostics[file->diagnostics_count + k];
+      u32 argument = file->strings_count + k;
+      strings[argument]        = string8_copy(arena, finding->diagnostic.argument);
+      diagnostic->rule         = finding->diagnostic.code;
+      diagnostic->code         = Parser_Error_None;
+      diagnostic->arguments[0] = argument;
+      diagnostic->arguments[1] = 0;
+      diagnostic->position     = finding->position;
+      diagnostic->start_offset = finding->diagnostic.start_offset;
+      diagnostic->end_offset   = finding->diagnostic.end_offset;
+    }
+    file->diagnostics        = diagnostics;
+    file->diagnostics_count += added;
+    file->strings            = strings;
+    file->strings_count     += added;
+    qsort(file->diagnostics, file->diagnostics_count, sizeof(Analysis_Diagnostic), analysis_diagnostic_compare);
+  }
+  scratch_end(&scratch);
+}
+
+internal b32 analysis_is_source(String8 path) {
+  b32 result = file_has_extension(path, Str8(".c")) || file_has_extension(path, Str8(".h"));
+  return result;
+}
+
+internal int analysis_file_compare(const void* a, const void* b) {
+  int result = string8_compare(((Analysis_File*)a)->path, ((Analysis_File*)b)->path);
+  return result;
+}
+
+internal int analysis_finding_compare(const void* a, const void* b) {
+  int result = string8_compare(((Symbol_Finding*)a)->path, ((Symbol_Finding*)b)->path);
+  return result;
+}
+
+internal int analysis_diagnostic_compare(const void* a, const void* b) {
+  Analysis_Diagnostic* diagnostic_a = (Analysis_Diagnostic*)a;
+  Analysis_Diagnostic* diagnostic_b = (Analysis_Diagnostic*)b;
+  int result = (diagnostic_a->start_offset > diagnostic_b->start_offset) - (diagnostic_a->start_offset < diagnostic_b->start_offset);
+  if (result == 0) {
+    result = (diagnostic_a->rule > diagnostic_b->rule) - (diagnostic_a->rule < diagnostic_b->rule);
+  }
+  if (result == 0) {
+    result = (diagnostic_a->code > diagnostic_b->code) - (diagnostic_a->code < diagnostic_b->code);
+  }
+  return result;
+}
+
+internal void analyze_file(Arena* arena, Analysis_File* file, Token_Array* tokens, Parser* parser) {
+  // NOTE(fz): Anything kept here must be copied into the worker arena, the lexer and parser are released after.
+  // Strings are copied once per file, diagnostics keep ids into them.
+  Arena_Temp scratch = scratch_begin(&arena, 1);
+  Rule_Context rules;
+  rules_run(scratch.arena, &rules, tokens, (parser != NULL) ? &parser->ast : NULL, file->path);
+  if (parser != NULL && file->symbols != NULL) {
+    symbols_collect(file->symbols, file->path, tokens, &parser->ast);
+  }
+
+  // Without a parser there are no errors, only the empty string every diagnostic's unused argument points to
+  String8 empty              = {0};
+  Parser_Strings no_strings = { .strings = &empty, .count = 1 };
+  Parser_Strings* strings   = (parser != NULL) ? &parser->strings : &no_strings;
+  u32 errors_count          = (parser != NULL) ? parser->errors_count : 0;
+  file->strings       = ArenaPushNoZero(arena, String8, strings->count + rules.diagnostics_count);
+  file->strings_count = strings->count + rules.diagnostics_count;
+  for (u32 i = 0; i < strings->count; i += 1) {
+    file->strings[i] = string8_copy(arena, strings->strings[i]);
+  }
+
+  file->diagnostics       = ArenaPushNoZero(arena, Analysis_Diagnostic, errors_count + rules.diagnostics_count);
+  file->diagnostics_count = errors_count + rules.diagnostics_count;
+  for (u32 i = 0; i < errors_count; i += 1) {
+    Parser_Error* error = &parser->errors[i];
+    Analysis_Diagnostic* diagnostic = &file->diagnostics[i];
+    diagnostic->rule         = Rule_None;
+    diagnostic->code         = error->code;
+    MemoryCopy(diagnostic->arguments, error->arguments, sizeof(error->arguments));
+    diagnostic->position     = text_position_from_offset(&tokens->lines, error->start_offset);
+    diagnostic->start_offset = error->start_offset;
+    diagnostic->end_offset   = error->end_offset;
+  }
+
+  for (u32 i = 0; i < rules.diagnostics_count; i += 1) {
+    Rule_Diagnostic* found = &rules.diagnostics[i];
+    Analysis_Diagnostic* diagnostic = &file->diagnostics[errors_count + i];
+    u32 argument = strings->count + i;
+    file->strings[argument] = string8_copy(arena, found->argument);
+    diagnostic->rule         = found->code;
+    diagnostic->code         = Parser_Error_None;
+    diagnostic->arguments[0] = argument;
+    diagnostic->arguments[1] = 0;
+    diagnostic->position     = text_position_from_offset(&tokens->lines, found->start_offset);
+    diagnostic->start_offset = found->start_offset;
+    diagnostic->end_offset   = found->end_offset;
+  }
+  scratch_end(&scratch);
+
+  qsort(file->diagnostics, file->diagnostics_count, sizeof(Analysis_Diagnostic), analysis_diagnostic_compare);
+}
@@ -0,0 +1,103 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+// DOC(fz): Runs lex -> parse -> analyze for every file on a work stealing thread pool.
+// Each file is one job and writes only to its own Analysis_File, allocating from the worker arena,
+// so no locks are needed. Files keep the order they were given in, which makes the report deterministic
+// regardless of which worker ran what. With a cache directory, a file whose cache entry is still valid skips lexing and
+// parsing and is analyzed straight from the mapped entry.
+//
+// analysis_run_tree finds the files on the same pool. Every directory is a job that pushes a job per subdirectory and
+// one per source file it lists, so lexing starts as soon as the first file is found instead of after the whole walk.
+// Names are filtered while listing, only source paths are ever built. Files end up sorted by path.
+//
+// Lint mode stops after lexing. Only the token rules run, nothing is parsed or cached, which is what a pre-commit hook
+// asking about whitespace and comments needs. Whitespace mode does not even lex, it maps the file and runs the byte
+// rules, the newline index is the only thing built and only to place what they find.
+//
+// In full mode every file also goes into a Symbol_Index, and the cross file rules add their diagnostics to the files
+// once the pool is done.
+
+typedef enum Analysis_Mode {
+  Analysis_Mode_Full = 0,   // Lex, parse, every rule
+  Analysis_Mode_Lint,       // Lex and the token rules only
+  Analysis_Mode_Whitespace, // The byte rules only, no tokens
+} Analysis_Mode;
+
+// NOTE(fz): Diagnostics keep the parser's compact form, the message is formatted by analysis_report.
+// A rule diagnostic has a rule and its one argument first, a parser error has Rule_None.
+typedef struct Analysis_Diagnostic {
+  Rule_Code rule;
+  Parser_Error_Code code;
+  u32 arguments[PARSER_ERROR_ARGUMENT_COUNT]; // Indices into Analysis_File.strings
+  Text_Position position;
+  u32 start_offset;
+  u32 end_offset;
+} Analysis_Diagnostic;
+
+typedef struct Analysis_File {
+  struct Analysis_File* next; // Found by the same worker, until analysis_run_tree gathers them
+  String8 path;
+  String8 cache_directory; // Empty when caching is off
+  Analysis_Mode mode;
+  Symbol_Index* symbols;   // NULL when the cross file rules are off
+  b32 is_cached;           // Lex and parse were skipped
+  b32 is_unreadable;       // Couldn't be opened or mapped, reported as one error instead of diagnostics
+  u64 bytes;
+  u64 tokens_count;
+  Analysis_Diagnostic* diagnostics;
+  u32 diagnostics_count;
+  String8* strings; // The parser's error strings copied once per file, then the rules' arguments
+  u32 strings_count;
+} Analysis_File;
+
+typedef struct Analysis {
+  Thread_Pool* pool;
+  Analysis_File* files;
+  u64 files_count;
+
+  u64 bytes;
+  u64 tokens_count;
+  u64 diagnostics_count;
+  u64 cached_count;
+  u64 elapsed_microseconds;
+} Analysis;
+
+// Shared by every job of analysis_run_tree
+typedef struct Analysis_Tree {
+  String8 cache_directory;
+  Analysis_Mode mode;
+  Symbol_Index* symbols;
+  Analysis_File** found; // One list per worker, a worker only touches its own
+  u64* found_counts;
+} Analysis_Tree;
+
+typedef struct Analysis_Directory {
+  Analysis_Tree* tree;
+  String8 path;
+} Analysis_Directory;
+
+// What a directory job hands to directory_visit
+typedef struct Analysis_Visit {
+  Arena* arena; // The worker's
+  Analysis_Tree* tree;
+} Analysis_Visit;
+
+internal Analysis analysis_run(Arena* arena, String8_List paths, u32 worker_count, String8 cache_directory, Analysis_Mode mode); /* worker_count of 0 uses every core, an empty cache_directory disables the cache */
+internal Analysis analysis_run_tree(Arena* arena, String8 root, u32 worker_count, String8 cache_directory, Analysis_Mode mode); /* Every .c and .h file under root */
+internal void     analysis_release(Analysis* analysis);
+internal void     analysis_report(Analysis* analysis);
+internal void     analysis_report_file(Arena* arena, String8_List* lines, Analysis_File* file); /* One line per diagnostic, as analysis_report prints them */
+
+internal void analysis_file_job(Arena* arena, void* context);
+internal void analysis_directory_job(Arena* arena, void* context);
+internal void analysis_directory_visit(String8 directory_path, String8 name, b32 is_directory, void* context);
+internal void analysis_merge(Analysis* analysis); /* Totals over files, in file order */
+internal void analysis_check_symbols(Arena* arena, Analysis* analysis, Symbol_Index* symbols); /* Adds what the cross file rules found to the files, before analysis_merge */
+internal b32  analysis_is_source(String8 path);
+internal int  analysis_file_compare(const void* a, const void* b);
+internal int  analysis_diagnostic_compare(const void* a, const void* b);
+internal int  analysis_finding_compare(const void* a, const void* b); /* By offset, then kind, so the report reads top to bottom */
+internal void analyze_file(Arena* arena, Analysis_File* file, Token_Array* tokens, Parser* parser); /* parser is NULL in lint mode */
+
+#endif // ANALYSIS_H
@@ -0,0 +1,250 @@
+///////////////
+// Benchmark
+internal void benchmark_run(Arena* arena) {
+  printf("\n==== Benchmarks ====\n");
+  intern_init();
+  benchmark_keywords(arena);
+  benchmark_expressions(arena);
+  benchmark_document(arena);
+}
+
+internal void benchmark_keywords(Arena* arena) {
+  Arena_Temp temp = arena_temp_begin(arena);
+
+  u64 total_bytes = 0;
+  String8* identifiers = benchmark_identifiers(temp.arena, BENCHMARK_IDENTIFIER_COUNT, &total_bytes);
+
+  u64 keywords = 0;
+
+  u64 start = time_now_microseconds();
+  for (u32 iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration += 1) {
+    for (u64 i = 0; i < BENCHMARK_IDENTIFIER_COUNT; i += 1) {
+      keywords += (benchmark_keyword_linear(identifiers[i]) != Token_Identifier);
+    }
+  }
+  f64 elapsed = (f64)(time_now_microseconds() - start) / 1000000.0;
+  benchmark_print("keywords (linear)", BENCHMARK_ITERATIONS*BENCHMARK_IDENTIFIER_COUNT, BENCHMARK_ITERATIONS*total_bytes, elapsed);
+
+  start = time_now_microseconds();
+  for (u32 iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration += 1) {
+    for (u64 i = 0; i < BENCHMARK_IDENTIFIER_COUNT; i += 1) {
+      keywords -= (is_token_keyword(identifiers[i]) != Token_Identifier);
+    }
+  }
+  elapsed = (f64)(time_now_microseconds() - start) / 1000000.0;
+  benchmark_print("keywords (hash)", BENCHMARK_ITERATIONS*BENCHMARK_IDENTIFIER_COUNT, BENCHMARK_ITERATIONS*total_bytes, elapsed);
+
+  // NOTE(fz): Both passes must agree, and using the result keeps the loops from being optimized away.
+  Assert(keywords == 0);
+
+  arena_temp_end(&temp);
+}
+
+internal void benchmark_expressions(Arena* arena) {
+  Arena_Temp temp = arena_temp_begin(arena);
+  String8 source  = benchmark_expression_source(temp.arena, BENCHMARK_EXPRESSION_BYTES);
+
+  Lexer lexer;
+  u64 start = time_now_microseconds();
+  Token_Array tokens = load_all_tokens_from_string(&lexer, source, Lexer_Flag_Merge_Whitespace | Lexer_Flag_Intern);
+  f64 elapsed = (f64)(time_now_microseconds() - start) / 1000000.0;
+  benchmark_print("expressions (lex)", tokens.count, source.size, elapsed);
+
+  Parser parser = {0};
+  start = time_now_microseconds();
+  parser_init(&parser, tokens, 0);
+  parser_skip_trivia(&parser);
+  while (current_token(&parser)->type != Token_End_Of_File) {
+    ast_add_child(&parser.ast, parser.ast.root, parse_expression(&parser));
+    parser_expect(&parser, Token_Semicolon);
+  }
+  elapsed = (f64)(time_now_microseconds() - start) / 1000000.0;
+  benchmark_print("expressions (parse)", parser.ast.count, source.size, elapsed);
+
+  // NOTE(fz): The generator only writes valid expressions
+  Assert(parser.errors_count == 0);
+
+  parser_free(&parser);
+  lexer_free(&lexer);
+  arena_temp_end(&temp);
+}
+
+internal void benchmark_document(Arena* arena) {
+  Arena_Temp temp = arena_temp_begin(arena);
+  String8 source  = benchmark_document_source(temp.arena, BENCHMARK_DOCUMENT_FUNCTIONS);
+
+  // What a keystroke costs without a document: the whole file again
+  u64 start = time_now_microseconds();
+  for (u32 iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration += 1) {
+    Lexer lexer;
+    Token_Array tokens = load_all_tokens_from_string(&lexer, source, Lexer_Flag_Merge_Whitespace | Lexer_Flag_Intern);
+    Parser parser = {0};
+    parse_ast(&parser, tokens);
+    parser_free(&parser);
+    lexer_free(&lexer);
+  }
+  f64 elapsed = (f64)(time_now_microseconds() - start) / 1000000.0;
+  benchmark_print("document (full)", BENCHMARK_ITERATIONS, BENCHMARK_ITERATIONS*source.size, elapsed);
+
+  Document document;
+  document_open(&document, source, Lexer_Flag_Merge_Whitespace | Lexer_Flag_Intern);
+
+  // NOTE(fz): A character typed at a random place and taken back. Bytes count the file once per edit, so MB/s compares with the full run.
+  u64 state  = 0x2545F4914F6CDD1D;
+  u64 tokens = 0;
+  start = time_now_microseconds();
+  for (u32 i = 0; i < BENCHMARK_DOCUMENT_EDITS; i += 1) {
+    u32 offset = (u32)(benchmark_random(&state) % document.file.data.size);
+    Document_Edit type = { .offset = offset, .removed_size = 0, .inserted = Str8("x") };
+    Document_Edit undo = { .offset = offset, .removed_size = 1 };
+    tokens += document_edit(&document, type).tokens_lexed;
+    tokens += document_edit(&document, undo).tokens_lexed;
+  }
+  elapsed = (f64)(time_now_microseconds() - start) / 1000000.0;
+  benchmark_print("document (edit)", 2*BENCHMARK_DOCUMENT_EDITS, 2*BENCHMARK_DOCUMENT_EDITS*source.size, elapsed);
+
+  // Every edit was undone
+  Assert(document.file.data.size == source.size && tokens > 0);
+
+  document_close(&document);
+  arena_temp_end(&temp);
+}
+
+internal String8 benchmark_document_source(Arena* arena, u64 functions) {
+  String8 result = { 0, ArenaPushNoZero(arena, char8, functions * Kilobytes(2)) };
+  u64 state = 0x9E3779B97F4A7C15;
+  for (u64 i = 0; i < functions; i += 1) {
+    Arena_Temp scratch = scratch_begin(0, 0);
+    benchmark_emit(&result, string8_format(scratch.arena, Str8("int function_%llu(int a, int count) {\n  int x = "), i));
+    benchmark_emit_expression(&result, &state, BENCHMARK_EXPRESSION_DEPTH - 2);
+    benchmark_emit(&result, Str8(";\n  if (x > a) { x = count; }\n  return x;\n}\n"));
+    scratch_end(&scratch);
+  }
+  return result;
+}
+
+internal String8 benchmark_expression_source(Arena* arena, u64 size) {
+  // NOTE(fz): One expression at the depth limit stays well under a kilobyte, leave that much room past size.
+  String8 result = { 0, ArenaPushNoZero(arena, char8, size + Kilobytes(64)) };
+  u64 state = 0x2545F4914F6CDD1D;
+  while (result.size < size) {
+    benchmark_emit_expression(&result, &state, 0);
+    benchmark_emit(&result, Str8(";\n"));
+  }
+  return result;
+}
+
+internal void benchmark_emit_expression(String8* out, u64* state, u32 depth) {
+  String8 atoms[] = {
+    Str8("a"), Str8("count"), Str8("node->next"), Str8("tokens[i]"), Str8("s.x"), Str8("42"), Str8("0xFF"), Str8("1.5f"), Str8("'c'"),
+  };
+  String8 binary[] = {
+    Str8(" + "), Str8(" - "), Str8(" * "), Str8(" / "), Str8(" % "), Str8(" << "), Str8(" >> "), Str8(" < "), Str8(" <= "),
+    Str8(" == "), Str8(" != "), Str8(" & "), Str8(" | "), Str8(" ^ "), Str8(" && "), Str8(" || "), Str8(" = "), Str8(" += "),
+  };
+  String8 unary[] = { Str8("-"), Str8("!"), Str8("~"), Str8("*"), Str8("&"), Str8("++"), Str8("(u32)"), Str8("sizeof ") };
+
+  u64 roll = benchmark_random(state);
+  if (depth >= BENCHMARK_EXPRESSION_DEPTH) {
+    roll = 0;
+  }
+
+  switch (roll % 8) {
+    case 0:
+    case 1: {
+      benchmark_emit(out, atoms[(roll >> 8) % ArrayCount(atoms)]);
+    } break;
+
+    case 2: {
+      benchmark_emit(out, unary[(roll >> 8) % ArrayCount(unary)]);
+      benchmark_emit_expression(out, state, BENCHMARK_EXPRESSION_DEPTH);
+    } break;
+
+    case 3: {
+      benchmark_emit(out, Str8("("));
+      benchmark_emit_expression(out, state, depth + 1);
+      benchmark_emit(out, Str8(")"));
+    } break;
+
+    case 4: {
+      benchmark_emit(out, Str8("call("));
+      benchmark_emit_expression(out, state, depth + 1);
+      benchmark_emit(out, Str8(", "));
+      benchmark_emit_expression(out, state, depth + 1);
+      benchmark_emit(out, Str8(")"));
+    } break;
+
+    case 5: {
+      benchmark_emit_expression(out, state, depth + 1);
+      benchmark_emit(out, Str8(" ? "));
+      benchmark_emit_expression(out, state, depth + 1);
+      benchmark_emit(out, Str8(" : "));
+      benchmark_emit_expression(out, state, depth + 1);
+    } break;
+
+    default: {
+      benchmark_emit_expression(out, state, depth + 1);
+      benchmark_emit(out, binary[(roll >> 8) % ArrayCount(binary)]);
+      benchmark_emit_expression(out, state, depth + 1);
+    } break;
+  }
+}
+
+internal void benchmark_emit(String8* out, String8 text) {
+  MemoryCopy(out->str + out->size, text.str, text.size);
+  out->size += text.size;
+}
+
+internal String8* benchmark_identifiers(Arena* arena, u64 count, u64* total_bytes) {
+  String8 pool[] = {
+    Str8("count"), Str8("index"), Str8("result"), Str8("node"),   Str8("token"),
+    Str8("parser"), Str8("lexer"), Str8("size"),  Str8("data"),   Str8("value"),
+    Str8("i"),     Str8("j"),     Str8("x"),      Str8("arena"),  Str8("first"),
+    Str8("last"),  Str8("next"),  Str8("u32"),    Str8("String8"), Str8("_internal_name"),
+  };
+  u64 state = 0x9E3779B97F4A7C15;
+  u64 bytes = 0;
+
+  String8* result = ArenaPush(arena, String8, count);
+  for (u64 i = 0; i < count; i += 1) {
+    u64 roll = benchmark_random(&state);
+    if (roll % 5 == 0) {
+      const Keyword* keyword = NULL;
+      while (keyword == NULL || keyword->size == 0) {
+        keyword = &keyword_table[benchmark_random(&state) % KEYWORD_TABLE_SIZE];
+      }
+      result[i] = string8_new(keyword->size, (char8*)keyword->name);
+    } else {
+      result[i] = pool[roll % ArrayCount(pool)];
+    }
+    bytes += result[i].size;
+  }
+
+  *total_bytes = bytes;
+  return result;
+}
+
+internal Token_Type benchmark_keyword_linear(String8 value) {
+  for (u32 i = 0; i < KEYWORD_TABLE_SIZE; i += 1) {
+    const Keyword* keyword = &keyword_table[i];
+    if (keyword->size > 0 && string8_equal(value, string8_new(keyword->size, (char8*)keyword->name))) {
+      return keyword->type;
+    }
+  }
+  return Token_Identifier;
+}
+
+internal u64 benchmark_random(u64* state) {
+  u64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return x;
+}
+
+internal void benchmark_print(const char8* name, u64 items, u64 bytes, f32 seconds) {
+  f64 mb = (f64)bytes / (f64)Megabytes(1);
+  printf("%-24s %10llu items  %8.2f MB  %8.4f s  %8.2f MB/s  %8.2f ns/item\n",
+         name, items, mb, seconds, mb / seconds, (seconds * 1e9) / (f64)items);
+}
@@ -0,0 +1,28 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// DOC(fz): Benchmarks are compiled in with BENCHMARK 1 in main.c. They run on synthesized input so the numbers don't depend on dummy/.
+
+#define BENCHMARK_ITERATIONS      16
+#define BENCHMARK_IDENTIFIER_COUNT Million(1)
+#define BENCHMARK_EXPRESSION_BYTES Megabytes(16)
+#define BENCHMARK_EXPRESSION_DEPTH 6
+#define BENCHMARK_DOCUMENT_FUNCTIONS 4000 // Five lines each
+#define BENCHMARK_DOCUMENT_EDITS     1000
+
+internal void benchmark_run(Arena* arena);
+internal void benchmark_keywords(Arena* arena);
+internal void benchmark_expressions(Arena* arena);
+internal void benchmark_document(Arena* arena); /* Keystrokes on a large file, full re-parse vs Document edits */
+
+// Help
+internal String8*   benchmark_identifiers(Arena* arena, u64 count, u64* total_bytes); /* Returns count identifiers, roughly 1 in 5 is a keyword */
+internal Token_Type benchmark_keyword_linear(String8 value);                          /* Reference: one string compare per keyword */
+internal String8    benchmark_expression_source(Arena* arena, u64 size);           /* Expression statements like dummy/expressions.c, one per line */
+internal void       benchmark_emit_expression(String8* out, u64* state, u32 depth); /* Appends one random expression, out must have room */
+internal String8    benchmark_document_source(Arena* arena, u64 functions);      /* Small functions around random expressions */
+internal void       benchmark_emit(String8* out, String8 text);
+internal u64        benchmark_random(u64* state);
+internal void       benchmark_print(const char8* name, u64 items, u64 bytes, f32 seconds);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,270 @@
+///////////////
+// Cache
+global const u64 cache_section_element_sizes[Cache_Section_Count] = {
+  [Cache_Section_Path]         = sizeof(char8),
+  [Cache_Section_Tokens]       = sizeof(Token),
+  [Cache_Section_Lines]        = sizeof(u32),
+  [Cache_Section_Nodes]        = sizeof(AST_Node),
+  [Cache_Section_Trivia]       = sizeof(AST_Trivia),
+  [Cache_Section_Errors]       = sizeof(Parser_Error),
+  [Cache_Section_Strings]      = sizeof(Cache_String),
+  [Cache_Section_String_Bytes] = sizeof(char8),
+  [Cache_Section_Names]        = sizeof(Cache_String),
+};
+
+internal b32 cache_load(Arena* arena, String8 cache_directory, String8 file_path, String8 source, u64 modified_time, Lexer_Flags flags, Cache_Entry* entry, Parser* parser) {
+  MemoryZeroStruct(entry);
+  b32 result = false;
+
+  String8 path = cache_path(arena, cache_directory, file_path);
+  if (!file_exists(path)) {
+    return result;
+  }
+  entry->map = file_map_open(path);
+
+  String8 data = entry->map.data;
+  Cache_Header* header = (Cache_Header*)data.str;
+  if (data.size >= sizeof(Cache_Header) &&
+      header->magic       == CACHE_MAGIC   &&
+      header->version     == CACHE_VERSION &&
+      header->layout      == CACHE_LAYOUT  &&
+      header->lexer_flags == (u32)flags    &&
+      header->source_size == source.size) {
+    // NOTE(fz): A truncated or foreign file must not send reads past the mapping.
+    b32 in_bounds = true;
+    for (u32 i = 0; i < Cache_Section_Count && in_bounds; i += 1) {
+      Cache_Section section = header->sections[i];
+      in_bounds = (section.offset <= data.size && section.count <= (data.size - section.offset) / cache_section_element_sizes[i]);
+    }
+
+    if (in_bounds) {
+      Cache_Section path_section = header->sections[Cache_Section_Path];
+      String8 stored_path = string8_new(path_section.count, (char8*)data.str + path_section.offset);
+      if (string8_equal(stored_path, file_path)) {
+        // Same modified time skips hashing, a touched but unchanged file still hits on the hash
+        result = (modified_time != 0 && header->modified_time == modified_time) || header->content_hash == cache_hash(source);
+      }
+    }
+  }
+
+  if (result) {
+    MemoryZeroStruct(parser);
+    entry->header = header;
+    u8* base = data.str;
+    Cache_Section* sections = header->sections;
+
+    parser->tokens.count         = sections[Cache_Section_Tokens].count;
+    parser->tokens.source        = source;
+    parser->tokens.lines.offsets = (u32*)(base + sections[Cache_Section_Lines].offset);
+    parser->tokens.lines.count   = sections[Cache_Section_Lines].count;
+
+    AST* ast = &parser->ast;
+    ast->nodes           = (AST_Node*)(base + sections[Cache_Section_Nodes].offset);
+    ast->count           = (u32)sections[Cache_Section_Nodes].count;
+    ast->capacity        = ast->count;
+    ast->root            = header->root;
+    ast->trivia          = (AST_Trivia*)(base + sections[Cache_Section_Trivia].offset);
+    ast->trivia_count    = (u32)sections[Cache_Section_Trivia].count;
+    ast->trivia_capacity = ast->trivia_count;
+
+    parser->errors          = (Parser_Error*)(base + sections[Cache_Section_Errors].offset);
+    parser->errors_count    = (u32)sections[Cache_Section_Errors].count;
+    parser->errors_capacity = parser->errors_count;
+
+    // Names are interned once each, then identifiers go from name index to id
+    Arena_Temp scratch  = scratch_begin(&arena, 1);
+    Cache_String* names = (Cache_String*)(base + sections[Cache_Section_Names].offset);
+    u64 names_count     = sections[Cache_Section_Names].count;
+    Intern_Id* ids      = ArenaPushNoZero(scratch.arena, Intern_Id, names_count + 1);
+    ids[0] = 0;
+    for (u64 i = 0; i < names_count; i += 1) {
+      ids[i + 1] = intern_string8(string8_slice(source, names[i].offset, (u64)names[i].offset + names[i].size));
+    }
+    Token* tokens = ArenaPushNoZero(arena, Token, parser->tokens.count);
+    MemoryCopy(tokens, base + sections[Cache_Section_Tokens].offset, parser->tokens.count * sizeof(Token));
+    for (u64 i = 0; i < parser->tokens.count; i += 1) {
+      if (tokens[i].type == Token_Identifier) {
+        tokens[i].id = (tokens[i].id <= names_count) ? ids[tokens[i].id] : 0;
+      }
+    }
+    parser->tokens.tokens = tokens;
+    scratch_end(&scratch);
+
+    // Strings are the only thing stored as offsets that the parser keeps as pointers
+    Cache_String* strings = (Cache_String*)(base + sections[Cache_Section_Strings].offset);
+    Cache_Section bytes   = sections[Cache_Section_String_Bytes];
+    parser->strings.count    = (u32)sections[Cache_Section_Strings].count;
+    parser->strings.capacity = parser->strings.count;
+    parser->strings.strings  = ArenaPushNoZero(arena, String8, parser->strings.count);
+    for (u32 i = 0; i < parser->strings.count; i += 1) {
+      u64 offset = Min((u64)strings[i].offset, bytes.count);
+      u64 size   = Min((u64)strings[i].size, bytes.count - offset);
+      parser->strings.strings[i] = string8_new(size, (char8*)base + bytes.offset + offset);
+    }
+  } else {
+    cache_close(entry);
+  }
+
+  return result;
+}
+
+internal void cache_store(String8 cache_directory, String8 file_path, u64 modified_time, Lexer_Flags flags, Parser* parser) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  Token_Array* tokens     = &parser->tokens;
+  AST* ast                = &parser->ast;
+  Parser_Strings* strings = &parser->strings;
+
+  u64 string_bytes = 0;
+  for (u32 i = 0; i < strings->count; i += 1) {
+    string_bytes += strings->strings[i].size;
+  }
+
+  // Distinct names in order of first use, found by intern id. Each identifier gets its name's index + 1.
+  u64 identifiers_count = 0;
+  for (u64 i = 0; i < tokens->count; i += 1) {
+    identifiers_count += (tokens->tokens[i].type == Token_Identifier);
+  }
+  u64 slots_count = 16;
+  while (slots_count < identifiers_count * 2) {
+    slots_count *= 2;
+  }
+  u32* slots            = ArenaPush(scratch.arena, u32, slots_count); // Name index + 1, 0 is an empty slot
+  Intern_Id* name_ids   = ArenaPushNoZero(scratch.arena, Intern_Id, identifiers_count);
+  Cache_String* names   = ArenaPushNoZero(scratch.arena, Cache_String, identifiers_count);
+  u32* identifier_names = ArenaPushNoZero(scratch.arena, u32, identifiers_count);
+  u32 names_count       = 0;
+  u64 identifier        = 0;
+  for (u64 i = 0; i < tokens->count; i += 1) {
+    Token token = tokens->tokens[i];
+    if (token.type != Token_Identifier) continue;
+    if (!HasFlags(flags, Lexer_Flag_Intern)) {
+      identifier_names[identifier++] = 0;
+      continue;
+    }
+
+    u64 slot = (token.id * 2654435761u) & (slots_count - 1);
+    while (slots[slot] != 0 && name_ids[slots[slot] - 1] != token.id) {
+      slot = (slot + 1) & (slots_count - 1);
+    }
+    if (slots[slot] == 0) {
+      name_ids[names_count] = token.id;
+      names[names_count]    = (Cache_String){ token.start_offset, token.length };
+      names_count += 1;
+      slots[slot] = names_count;
+    }
+    identifier_names[identifier++] = slots[slot];
+  }
+
+  Cache_Header header  = {0};
+  header.magic         = CACHE_MAGIC;
+  header.version       = CACHE_VERSION;
+  header.layout        = CACHE_LAYOUT;
+  header.lexer_flags   = (u32)flags;
+  header.source_size   = tokens->source.size;
+  header.modified_time = modified_time;
+  header.content_hash  = cache_hash(tokens->source);
+  header.root          = ast->root;
+
+  u64 counts[Cache_Section_Count] = {
+    [Cache_Section_Path]         = file_path.size,
+    [Cache_Section_Tokens]       = tokens->count,
+    [Cache_Section_Lines]        = tokens->lines.count,
+    [Cache_Section_Nodes]        = ast->count,
+    [Cache_Section_Trivia]       = ast->trivia_count,
+    [Cache_Section_Errors]       = parser->errors_count,
+    [Cache_Section_Strings]      = strings->count,
+    [Cache_Section_String_Bytes] = string_bytes,
+    [Cache_Section_Names]        = names_count,
+  };
+  void* sources[Cache_Section_Count] = {
+    [Cache_Section_Path]   = file_path.str,
+    [Cache_Section_Tokens] = tokens->tokens,
+    [Cache_Section_Lines]  = tokens->lines.offsets,
+    [Cache_Section_Nodes]  = ast->nodes,
+    [Cache_Section_Trivia] = ast->trivia,
+    [Cache_Section_Errors] = parser->errors,
+    [Cache_Section_Names]  = names,
+  };
+
+  u64 size = AlignPow2(sizeof(Cache_Header), 8);
+  for (u32 i = 0; i < Cache_Section_Count; i += 1) {
+    header.sections[i].offset = size;
+    header.sections[i].count  = counts[i];
+    size = AlignPow2(size + counts[i] * cache_section_element_sizes[i], 8);
+  }
+
+  // Pushed zeroed so the padding is deterministic
+  u8* buffer = ArenaPush(scratch.arena, u8, size);
+  MemoryCopy(buffer, &header, sizeof(header));
+  for (u32 i = 0; i < Cache_Section_Count; i += 1) {
+    if (sources[i] != NULL && counts[i] > 0) {
+      MemoryCopy(buffer + header.sections[i].offset, sources[i], counts[i] * cache_section_element_sizes[i]);
+    }
+  }
+
+  Token* stored_tokens = (Token*)(buffer + header.sections[Cache_Section_Tokens].offset);
+  identifier = 0;
+  for (u64 i = 0; i < tokens->count; i += 1) {
+    if (stored_tokens[i].type == Token_Identifier) {
+      stored_tokens[i].id = identifier_names[identifier++];
+    }
+  }
+
+  Cache_String* cache_strings = (Cache_String*)(buffer + header.sections[Cache_Section_Strings].offset);
+  u8* bytes  = buffer + header.sections[Cache_Section_String_Bytes].offset;
+  u32 offset = 0;
+  for (u32 i = 0; i < strings->count; i += 1) {
+    String8 value = strings->strings[i];
+    cache_strings[i].offset = offset;
+    cache_strings[i].size   = (u32)value.size;
+    if (value.size > 0) {
+      MemoryCopy(bytes + offset, value.str, value.size);
+    }
+    offset += (u32)value.size;
+  }
+
+  // NOTE(fz): Written under a temporary name and renamed over the old entry, so a reader never maps a half written file.
+  String8 path      = cache_path(scratch.arena, cache_directory, file_path);
+  String8 temporary = string8_format(scratch.arena, Str8("%.*s.tmp"), (s32)path.size, path.str);
+  if (file_overwrite(temporary, (char8*)buffer, size) == size) {
+    file_rename(temporary, path);
+  }
+
+  scratch_end(&scratch);
+}
+
+internal void cache_close(Cache_Entry* entry) {
+  file_map_close(&entry->map);
+  MemoryZeroStruct(entry);
+}
+
+internal u64 cache_hash(String8 data) {
+  // NOTE(fz): 8 bytes per step, each multiplied in and folded down, then the murmur3 finalizer for the last bits.
+  u64 result = 0x9E3779B97F4A7C15ull ^ (data.size * 0xFF51AFD7ED558CCDull);
+  u64 i = 0;
+  for (; i + 8 <= data.size; i += 8) {
+    u64 word;
+    MemoryCopy(&word, data.str + i, sizeof(word));
+    result  = (result ^ word) * 0xBF58476D1CE4E5B9ull;
+    result ^= result >> 31;
+  }
+  if (i < data.size) {
+    u64 tail = 0;
+    MemoryCopy(&tail, data.str + i, data.size - i);
+    result  = (result ^ tail) * 0xBF58476D1CE4E5B9ull;
+    result ^= result >> 31;
+  }
+
+  result ^= result >> 33;
+  result *= 0xFF51AFD7ED558CCDull;
+  result ^= result >> 33;
+  result *= 0xC4CEB9FE1A85EC53ull;
+  result ^= result >> 33;
+  return result;
+}
+
+internal String8 cache_path(Arena* arena, String8 cache_directory, String8 file_path) {
+  String8 name   = string8_format(arena, Str8("%016llx" CACHE_EXTENSION), cache_hash(file_path));
+  String8 result = path_join(arena, cache_directory, name);
+  return result;
+}
@@ -0,0 +1,64 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+// DOC(fz): On-disk cache of what lexing and parsing produced for one file: tokens, line index, AST, trivia and errors.
+// There is one cache file per source file, named after a hash of the source path. A cache file is a header followed by
+// flat arrays at 8 byte aligned offsets. Everything in it links by index or offset, so a mapped cache file is used in
+// place. Only the tokens are copied on load: intern ids mean nothing to another process, so identifiers are stored with
+// the index of their name in the file's Names section instead, and each name is interned once when the entry is loaded. An entry is valid when version, layout, lexer flags, path and size match and
+// either the modified time or the content hash of the source does.
+
+#define CACHE_MAGIC     0x43415A46u // "FZAC"
+#define CACHE_VERSION   6           // NOTE(fz): Bump whenever the parser starts producing a different tree for the same source
+#define CACHE_LAYOUT    ((u32)sizeof(Token) | ((u32)sizeof(AST_Node) << 8) | ((u32)sizeof(AST_Trivia) << 16) | ((u32)sizeof(Parser_Error) << 24))
+#define CACHE_EXTENSION ".fzc"
+
+typedef enum Cache_Section_Type {
+  Cache_Section_Path,         // char8, the source path, to tell path hash collisions apart
+  Cache_Section_Tokens,       // Token
+  Cache_Section_Lines,        // u32, Line_Index offsets
+  Cache_Section_Nodes,        // AST_Node, index 0 is the nil node
+  Cache_Section_Trivia,       // AST_Trivia
+  Cache_Section_Errors,       // Parser_Error
+  Cache_Section_Strings,      // Cache_String, Parser_Strings in id order
+  Cache_Section_String_Bytes, // char8
+  Cache_Section_Names,        // Cache_String, offset and size into the source. A stored Token_Identifier's id is 1 + its index here, 0 for none
+  Cache_Section_Count,
+} Cache_Section_Type;
+
+typedef struct Cache_Section {
+  u64 offset; // From the start of the cache file
+  u64 count;  // Elements, not bytes
+} Cache_Section;
+
+typedef struct Cache_String {
+  u32 offset; // Into Cache_Section_String_Bytes
+  u32 size;
+} Cache_String;
+
+typedef struct Cache_Header {
+  u32 magic;
+  u32 version;
+  u32 layout;
+  u32 lexer_flags;
+  u64 source_size;
+  u64 modified_time;
+  u64 content_hash;
+  AST_Index root;
+  u32 reserved;
+  Cache_Section sections[Cache_Section_Count];
+} Cache_Header;
+
+// A cache file mapped for reading, the Parser filled by cache_load points into it
+typedef struct Cache_Entry {
+  File_Map map;
+  Cache_Header* header;
+} Cache_Entry;
+
+internal b32     cache_load(Arena* arena, String8 cache_directory, String8 file_path, String8 source, u64 modified_time, Lexer_Flags flags, Cache_Entry* entry, Parser* parser); /* On a hit, parser is a read only view into entry. Only the tokens and the string table are built in arena */
+internal void    cache_store(String8 cache_directory, String8 file_path, u64 modified_time, Lexer_Flags flags, Parser* parser);
+internal void    cache_close(Cache_Entry* entry); /* The parser view from cache_load is invalid afterwards */
+internal u64     cache_hash(String8 data);        /* Fast 64 bit content hash, not cryptographic */
+internal String8 cache_path(Arena* arena, String8 cache_directory, String8 file_path);
+
+#endif // CACHE_H
@@ -0,0 +1,406 @@
+///////////////
+// Daemon
+internal b32 daemon_start(Daemon* daemon, Arena* arena, String8 root, u32 worker_count) {
+  MemoryZeroStruct(daemon);
+  daemon->arena  = arena;
+  daemon->root   = path_new(arena, root);
+  daemon->name   = daemon_name(arena, daemon->root);
+  daemon->server = local_socket_listen(daemon->name);
+  if (!local_socket_is_valid(&daemon->server)) {
+    return false;
+  }
+
+  intern_init();
+  rules_init();
+  daemon->pool        = thread_pool_init(arena, worker_count);
+  daemon->files_arena  = arena_init();
+  daemon->slots_arena  = arena_init();
+  daemon->slots_count  = DAEMON_SLOTS_FIRST_COUNT;
+  daemon->slots        = ArenaPush(daemon->slots_arena, u32, daemon->slots_count);
+  daemon->sorted_arena = arena_init();
+  daemon->report_arena = arena_init();
+  // NOTE(fz): The watch starts before the tree is read, a file written in between is reported twice rather than missed.
+  daemon->watch = file_watch_open(daemon->root);
+  daemon_mark(daemon, daemon->root);
+  daemon_refresh(daemon);
+  return true;
+}
+
+internal void daemon_run(Daemon* daemon) {
+  b32 stop = false;
+  while (!stop) {
+    Local_Socket client = local_socket_accept(&daemon->server, DAEMON_IDLE_MILLISECONDS);
+    daemon_refresh(daemon);
+    if (!local_socket_is_valid(&client)) {
+      continue;
+    }
+
+    // Requests are one line, read until the newline or until the client stops writing
+    Arena_Temp scratch = scratch_begin(0, 0);
+    char8 request[DAEMON_REQUEST_SIZE];
+    u64 request_size = 0;
+    while (request_size < DAEMON_REQUEST_SIZE) {
+      String8 chunk = local_socket_read(scratch.arena, &client, DAEMON_REQUEST_SIZE - request_size);
+      if (chunk.size == 0) break;
+      MemoryCopy(request + request_size, chunk.str, chunk.size);
+      request_size += chunk.size;
+      if (memchr(chunk.str, '\n', chunk.size) != NULL) break;
+    }
+
+    String8 reply = daemon_reply(scratch.arena, daemon, string8_new(request_size, request), &stop);
+    local_socket_write(&client, reply);
+    local_socket_close(&client);
+    scratch_end(&scratch);
+  }
+}
+
+internal void daemon_stop(Daemon* daemon) {
+  local_socket_close(&daemon->server);
+  file_watch_close(&daemon->watch);
+  for (u64 i = 0; i < daemon->files_count; i += 1) {
+    Daemon_File* file = &daemon->files[i];
+    if (file->is_open) {
+      document_close(&file->document);
+    }
+    if (file->arena != NULL) {
+      arena_free(file->arena);
+    }
+  }
+  if (daemon->pool != NULL) {
+    thread_pool_release(daemon->pool);
+  }
+  if (daemon->files_arena != NULL) {
+    arena_free(daemon->files_arena);
+    arena_free(daemon->slots_arena);
+    arena_free(daemon->sorted_arena);
+    arena_free(daemon->report_arena);
+  }
+  MemoryZeroStruct(daemon);
+}
+
+internal b32 daemon_request(Arena* arena, String8 root, String8 request, String8* reply) {
+  MemoryZeroStruct(reply);
+  Local_Socket socket = local_socket_connect(daemon_name(arena, path_new(arena, root)));
+  if (!local_socket_is_valid(&socket)) {
+    return false;
+  }
+
+  String8_List chunks = {0};
+  if (local_socket_write(&socket, string8_format(arena, Str8("%.*s\n"), (s32)request.size, request.str))) {
+    for (;;) {
+      String8 chunk = local_socket_read(arena, &socket, DAEMON_REPLY_CHUNK_SIZE);
+      if (chunk.size == 0) break;
+      string8_list_push(arena, &chunks, chunk);
+    }
+  }
+  local_socket_close(&socket);
+
+  *reply = string8_list_join(arena, &chunks);
+  return true;
+}
+
+internal String8 daemon_name(Arena* arena, String8 root) {
+  // NOTE(fz): One daemon per tree. Named after the root so daemons for different trees don't collide.
+  String8 result = string8_format(arena, Str8("fz_sane_%016llx"), cache_hash(root));
+  return result;
+}
+
+internal void daemon_refresh(Daemon* daemon) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  String8_List changes = file_watch_read(scratch.arena, &daemon->watch);
+  for (String8_Node* node = changes.first; node != NULL; node = node->next) {
+    daemon_mark(daemon, node->value);
+  }
+  scratch_end(&scratch);
+
+  u64 count = 0;
+  for (u64 i = 0; i < daemon->files_count; i += 1) {
+    if (daemon->files[i].is_changed) {
+      thread_pool_push(daemon->pool, daemon_file_job, &daemon->files[i]);
+      count += 1;
+    }
+  }
+  if (count == 0) {
+    return;
+  }
+
+  u64 start = time_now_microseconds();
+  thread_pool_run(daemon->pool);
+  daemon_check_symbols(daemon);
+  daemon->refreshed_count      = count;
+  daemon->refresh_microseconds = time_now_microseconds() - start;
+  printf("%llu files analyzed in %.4f s\n", count, (f64)daemon->refresh_microseconds / 1000000.0);
+  fflush(stdout);
+}
+
+internal void daemon_mark(Daemon* daemon, String8 path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  path = path_new(scratch.arena, path);
+
+  if (path_is_directory(path)) {
+    // Whatever the directory holds now, the files it held before are marked below
+    String8_List paths = file_get_all_file_paths_recursively(scratch.arena, path);
+    for (String8_Node* node = paths.first; node != NULL; node = node->next) {
+      String8 file_path = path_new(scratch.arena, node->value);
+      if (analysis_is_source(file_path)) {
+        daemon_file_from_path(daemon, file_path, true)->is_changed = true;
+      }
+    }
+  } else if (analysis_is_source(path)) {
+    Daemon_File* file = daemon_file_from_path(daemon, path, path_is_file(path));
+    if (file != NULL) {
+      file->is_changed = true;
+    }
+  }
+
+  // A directory that was deleted or moved away takes its files with it
+  u64 under_count = 0;
+  Daemon_Path* under = daemon_files_under(daemon, path, &under_count);
+  for (u64 i = 0; i < under_count; i += 1) {
+    Daemon_File* file = &daemon->files[under[i].file];
+    if (file->is_open) {
+      file->is_changed = true;
+    }
+  }
+
+  scratch_end(&scratch);
+}
+
+internal void daemon_check_symbols(Daemon* daemon) {
+  // NOTE(fz): The index has no way to drop a file, so it is built again from every open document. Collecting only walks
+  // the top level constructs of trees already parsed, which is small next to the re-analysis that got us here.
+  arena_clear(daemon->report_arena);
+  Symbol_Index symbols;
+  symbol_index_init(&symbols);
+
+  daemon->report_count = 0;
+  daemon->report = ArenaPushNoZero(daemon->report_arena, Analysis_File, daemon->files_count);
+  for (u64 i = 0; i < daemon->files_count; i += 1) {
+    Daemon_File* file = &daemon->files[i];
+    if (file->is_open) {
+      Parser* parser = &file->document.parser;
+      symbols_collect(&symbols, file->path, &parser->tokens, &parser->ast);
+    } else if (!file->analysis.is_unreadable) {
+      continue;
+    }
+    daemon->report[daemon->report_count] = file->analysis;
+    daemon->report_count += 1;
+  }
+  qsort(daemon->report, daemon->report_count, sizeof(Analysis_File), analysis_file_compare);
+
+  // The copies get new arrays with the findings added, the files keep their own
+  Analysis analysis = {0};
+  analysis.files       = daemon->report;
+  analysis.files_count = daemon->report_count;
+  analysis_check_symbols(daemon->report_arena, &analysis, &symbols);
+  symbol_index_release(&symbols);
+}
+
+internal Daemon_File* daemon_file_from_path(Daemon* daemon, String8 path, b32 create) {
+  u64 hash = cache_hash(path);
+  u64 mask = daemon->slots_count - 1;
+  for (u64 slot = hash & mask; daemon->slots[slot] != 0; slot = (slot + 1) & mask) {
+    Daemon_File* file = &daemon->files[daemon->slots[slot] - 1];
+    if (file->path_hash == hash && string8_equal(file->path, path)) {
+      return file;
+    }
+  }
+  if (!create) {
+    return NULL;
+  }
+
+  daemon->files = document_reserve(daemon->files_arena, daemon->files, &daemon->files_capacity, daemon->files_count + 1, sizeof(Daemon_File));
+  u32 index = (u32)daemon->files_count;
+  Daemon_File* result = &daemon->files[index];
+  daemon->files_count += 1;
+  MemoryZeroStruct(result);
+  result->path      = string8_copy(daemon->arena, path);
+  result->path_hash = hash;
+
+  // NOTE(fz): Kept at most half full so probing stays short. Files are never removed, so the slots never are either.
+  if (daemon->files_count * 2 > daemon->slots_count) {
+    daemon->slots_count *= 2;
+    daemon->slots = ArenaPush(daemon->slots_arena, u32, daemon->slots_count);
+    for (u32 i = 0; i < index; i += 1) {
+      daemon_slots_insert(daemon->slots, daemon->slots_count, daemon->files[i].path_hash, i);
+    }
+  }
+  daemon_slots_insert(daemon->slots, daemon->slots_count, hash, index);
+  return result;
+}
+
+internal void daemon_slots_insert(u32* slots, u64 slots_count, u64 hash, u32 file) {
+  u64 mask = slots_count - 1;
+  u64 slot = hash & mask;
+  while (slots[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  slots[slot] = file + 1;
+}
+
+internal Daemon_Path* daemon_files_under(Daemon* daemon, String8 directory, u64* count) {
+  if (daemon->sorted_count != daemon->files_count) {
+    arena_clear(daemon->sorted_arena);
+    daemon->sorted       = ArenaPushNoZero(daemon->sorted_arena, Daemon_Path, daemon->files_count);
+    daemon->sorted_count = daemon->files_count;
+    for (u64 i = 0; i < daemon->files_count; i += 1) {
+      daemon->sorted[i] = (Daemon_Path){ .path = daemon->files[i].path, .file = (u32)i };
+    }
+    qsort(daemon->sorted, daemon->sorted_count, sizeof(Daemon_Path), daemon_path_compare);
+  }
+
+  // The paths under directory sort right after directory plus the separator and before anything else
+  Arena_Temp scratch = scratch_begin(0, 0);
+  String8 prefix = string8_format(scratch.arena, Str8("%.*s%c"), (s32)directory.size, directory.str, PATH_SEPARATOR);
+  u64 low  = 0;
+  u64 high = daemon->sorted_count;
+  while (low < high) {
+    u64 middle = low + (high - low) / 2;
+    if (string8_compare(daemon->sorted[middle].path, prefix) < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  u64 end = low;
+  while (end < daemon->sorted_count && daemon->sorted[end].path.size >= prefix.size &&
+         MemoryMatch(daemon->sorted[end].path.str, prefix.str, prefix.size)) {
+    end += 1;
+  }
+  scratch_end(&scratch);
+
+  *count = end - low;
+  return daemon->sorted + low;
+}
+
+internal int daemon_path_compare(const void* a, const void* b) {
+  int result = string8_compare(((Daemon_Path*)a)->path, ((Daemon_Path*)b)->path);
+  return result;
+}
+
+internal String8 daemon_reply(Arena* arena, Daemon* daemon, String8 request, b32* stop) {
+  String8 result  = {0};
+  String8 command = string8_trim(request);
+
+  if (string8_equal(command, Str8("report"))) {
+    String8_List lines = {0};
+    u64 files_count = 0;
+    u64 bytes = 0;
+    u64 tokens_count = 0;
+    u64 diagnostics_count = 0;
+    for (u64 i = 0; i < daemon->report_count; i += 1) {
+      Analysis_File* file = &daemon->report[i];
+      analysis_report_file(arena, &lines, file);
+      files_count       += 1;
+      bytes             += file->bytes;
+      tokens_count      += file->tokens_count;
+      diagnostics_count += file->diagnostics_count + file->is_unreadable; // As analysis_merge counts them
+    }
+
+    f64 mb = (f64)bytes / (f64)Megabytes(1);
+    string8_list_push(arena, &lines, string8_format(arena, Str8("%llu files (%llu re-analyzed in %.4f s), %.2f MB, %llu tokens, %llu diagnostics (daemon, %u workers)\n"),
+                                                    files_count, daemon->refreshed_count, (f64)daemon->refresh_microseconds / 1000000.0,
+                                                    mb, tokens_count, diagnostics_count, daemon->pool->worker_count));
+    result = string8_list_join(arena, &lines);
+  } else if (string8_equal(command, Str8("stop"))) {
+    *stop  = true;
+    result = Str8("stopped\n");
+  } else {
+    result = string8_format(arena, Str8("Unknown request '%.*s', expected report or stop\n"), (s32)command.size, command.str);
+  }
+
+  return result;
+}
+
+internal void daemon_file_job(Arena* arena, void* context) {
+  Daemon_File* file = (Daemon_File*)context;
+  Lexer_Flags flags = Lexer_Flag_Merge_Whitespace | Lexer_Flag_Intern;
+  file->is_changed  = false;
+
+  if (!path_is_file(file->path)) {
+    // Deleted or moved away. The slot stays, closed, in case the file comes back
+    if (file->is_open) {
+      document_close(&file->document);
+      file->is_open = false;
+    }
+    MemoryZeroStruct(&file->analysis);
+    return;
+  }
+
+  File_Map map = file_map_open(file->path);
+  if (!map.is_readable) {
+    // Still there but can't be read, reported until it can be
+    if (file->is_open) {
+      document_close(&file->document);
+      file->is_open = false;
+    }
+    MemoryZeroStruct(&file->analysis);
+    file->analysis.path          = file->path;
+    file->analysis.is_unreadable = true;
+    return;
+  }
+  if (file->is_open && !document_fits(&file->document, map.data.size)) {
+    // Grew past what its arenas were reserved for, opened again at the new size
+    document_close(&file->document);
+    file->is_open = false;
+  }
+  if (!file->is_open) {
+    document_open(&file->document, map.data, flags);
+    file->is_open = true;
+    if (file->arena != NULL) {
+      arena_free(file->arena);
+    }
+    file->arena = arena_init_resident(file->document.arena_reserve);
+  } else {
+    Document_Edit edit = daemon_edit_between(file->document.file.data, map.data);
+    if (edit.removed_size == 0 && edit.inserted.size == 0) {
+      // Written with the same bytes, the diagnostics still hold
+      file_map_close(&map);
+      return;
+    }
+    document_edit(&file->document, edit);
+  }
+  file_map_close(&map);
+
+  // NOTE(fz): analyze_file copies everything it keeps, so the file's arena only ever holds the latest diagnostics.
+  arena_clear(file->arena);
+  Parser* parser = &file->document.parser;
+  MemoryZeroStruct(&file->analysis);
+  file->analysis.path         = file->path;
+  file->analysis.bytes        = parser->tokens.source.size;
+  file->analysis.tokens_count = parser->tokens.count;
+  analyze_file(file->arena, &file->analysis, &parser->tokens, parser);
+}
+
+internal Document_Edit daemon_edit_between(String8 old_source, String8 new_source) {
+  // Common prefix, then common suffix of what is left, a word at a time while a whole word fits
+  u64 limit  = Min(old_source.size, new_source.size);
+  u64 prefix = 0;
+  for (; prefix + sizeof(u64) <= limit; prefix += sizeof(u64)) {
+    u64 a, b;
+    MemoryCopy(&a, old_source.str + prefix, sizeof(u64));
+    MemoryCopy(&b, new_source.str + prefix, sizeof(u64));
+    if (a != b) break;
+  }
+  while (prefix < limit && old_source.str[prefix] == new_source.str[prefix]) {
+    prefix += 1;
+  }
+
+  limit -= prefix;
+  u64 suffix = 0;
+  for (; suffix + sizeof(u64) <= limit; suffix += sizeof(u64)) {
+    u64 a, b;
+    MemoryCopy(&a, old_source.str + old_source.size - suffix - sizeof(u64), sizeof(u64));
+    MemoryCopy(&b, new_source.str + new_source.size - suffix - sizeof(u64), sizeof(u64));
+    if (a != b) break;
+  }
+  while (suffix < limit && old_source.str[old_source.size - suffix - 1] == new_source.str[new_source.size - suffix - 1]) {
+    suffix += 1;
+  }
+
+  Document_Edit result = {0};
+  result.offset        = (u32)prefix;
+  result.removed_size  = (u32)(old_source.size - prefix - suffix);
+  result.inserted      = string8_new(new_source.size - prefix - suffix, new_source.str + prefix);
+  return result;
+}
@@ -0,0 +1,84 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+// DOC(fz): Long running analyzer for a source tree. Every .c and .h file under the root stays resident as a Document
+// with its diagnostics, and a file watch says which ones changed. A changed file is diffed against the document to one
+// edit (everything between the common prefix and the common suffix), so saving a file re-lexes and re-parses only
+// around what changed. Changed files are analyzed on the thread pool while the daemon is idle, and again right
+// before answering, so a reply never reflects a stale tree. The cross file rules then run over every open document,
+// an edit to X.h can change what X.c reports, so a reply holds the same diagnostics as a one shot run.
+//
+// Clients connect to a local socket named after the root, send one request line and read the reply until the daemon
+// closes the connection. Requests:
+//   report  Every diagnostic followed by a summary line
+//   stop    Shuts the daemon down
+
+#define DAEMON_IDLE_MILLISECONDS 200 // How long to wait for a client before looking at the file watch again
+#define DAEMON_REQUEST_SIZE      256
+#define DAEMON_REPLY_CHUNK_SIZE  Kilobytes(64)
+#define DAEMON_SLOTS_FIRST_COUNT 1024
+
+typedef struct Daemon_File {
+  String8 path;
+  u64 path_hash;
+  b32 is_open;    // document holds the file
+  b32 is_changed; // Reported by the watch and not analyzed since
+  Document document;
+  Arena* arena;   // Diagnostics in analysis, cleared each time the file is analyzed again. Resident, sized like the document's
+  Analysis_File analysis;
+} Daemon_File;
+
+typedef struct Daemon_Path {
+  String8 path;
+  u32 file; // Index into Daemon.files
+} Daemon_Path;
+
+typedef struct Daemon {
+  Arena* arena;
+  String8 root;
+  String8 name; // Of the local socket
+  Thread_Pool* pool;
+  File_Watch watch;
+  Local_Socket server;
+
+  // NOTE(fz): Jobs point into files, so the array lives alone in its arena and grows in place like a Document's arrays.
+  Arena* files_arena;
+  Daemon_File* files; // Removed files keep their slot, closed, and get it back if they return
+  u64 files_count;
+  u64 files_capacity;
+
+  // NOTE(fz): A file is found by path through slots, the files under a directory are one run of sorted.
+  Arena* slots_arena;  // Slot tables, rebuilt twice as big when half full
+  u32* slots;          // Open addressing on path_hash, file index + 1, 0 is an empty slot
+  u64 slots_count;
+  Arena* sorted_arena; // Cleared each time sorted is rebuilt
+  Daemon_Path* sorted; // Every file by path, rebuilt on the first directory lookup after a file was added
+  u64 sorted_count;
+
+  Arena* report_arena;   // Cleared by every refresh that analyzed a file
+  Analysis_File* report; // Open files sorted by path, with what the cross file rules found added to each
+  u64 report_count;
+
+  u64 refreshed_count; // Files analyzed by the last refresh
+  u64 refresh_microseconds;
+} Daemon;
+
+internal b32     daemon_start(Daemon* daemon, Arena* arena, String8 root, u32 worker_count); /* False if a daemon already serves root */
+internal void    daemon_run(Daemon* daemon);                                                 /* Serves requests until one says stop */
+internal void    daemon_stop(Daemon* daemon);
+internal b32     daemon_request(Arena* arena, String8 root, String8 request, String8* reply); /* Client side. False if no daemon serves root */
+internal String8 daemon_name(Arena* arena, String8 root);
+
+// Help
+internal void          daemon_refresh(Daemon* daemon);            /* Applies what the watch reported and analyzes every changed file */
+internal void          daemon_mark(Daemon* daemon, String8 path); /* path changed. For a directory, every file under it did */
+internal void          daemon_check_symbols(Daemon* daemon);      /* Builds report, runs the cross file rules over every open document */
+internal Daemon_File*  daemon_file_from_path(Daemon* daemon, String8 path, b32 create);
+internal void          daemon_slots_insert(u32* slots, u64 slots_count, u64 hash, u32 file);
+internal Daemon_Path*  daemon_files_under(Daemon* daemon, String8 directory, u64* count); /* Every file whose path starts with directory and a separator */
+internal int           daemon_path_compare(const void* a, const void* b);
+internal String8       daemon_reply(Arena* arena, Daemon* daemon, String8 request, b32* stop);
+internal void          daemon_file_job(Arena* arena, void* context);
+internal Document_Edit daemon_edit_between(String8 old_source, String8 new_source); /* One edit turning old_source into new_source */
+
+#endif // DAEMON_H
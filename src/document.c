@@ -0,0 +1,523 @@
+///////////////
+// Document
+internal void document_open(Document* document, String8 source, Lexer_Flags flags) {
+  MemoryZeroStruct(document);
+  document->flags          = flags;
+  document->size_limit     = Max(source.size * 2, DOCUMENT_MIN_SIZE_LIMIT); // Room to grow before it must be opened again
+  document->arena_reserve  = document_arena_reserve(document->size_limit);
+  document->source_arena   = arena_init_resident(document->arena_reserve);
+  document->tokens_arena   = arena_init_resident(document->arena_reserve);
+  document->lines_arena    = arena_init_resident(document->arena_reserve);
+  document->segments_arena = arena_init_resident(document->arena_reserve);
+
+  // NOTE(fz): Starts as the empty file, lexed and parsed, and the whole source goes in as one edit.
+  Token_Array tokens = {0};
+  document->file.data.str = document_reserve(document->source_arena, NULL, &document->source_capacity, 1, sizeof(char8));
+  tokens.tokens           = document_reserve(document->tokens_arena, NULL, &document->tokens_capacity, 1, sizeof(Token));
+  tokens.lines.offsets    = document_reserve(document->lines_arena, NULL, &document->lines_capacity, 1, sizeof(u32));
+  tokens.tokens[0]        = (Token){ .type = Token_End_Of_File, .count = 1 };
+  tokens.count            = 1;
+  tokens.source           = document->file.data;
+
+  Parser* parser = &document->parser;
+  parser_init(parser, tokens, document->arena_reserve);
+#if DEBUG
+  parser->file = &document->file;
+#endif
+
+  document->segments = document_reserve(document->segments_arena, NULL, &document->segments_capacity, 1, sizeof(Document_Segment));
+  document_record(parser, &document->segments[0]);
+  document->segments_count = 1;
+
+  Document_Edit edit = { .offset = 0, .removed_size = 0, .inserted = source };
+  document_edit(document, edit);
+}
+
+internal void document_close(Document* document) {
+  parser_free(&document->parser);
+  arena_free(document->segments_arena);
+  arena_free(document->lines_arena);
+  arena_free(document->tokens_arena);
+  arena_free(document->source_arena);
+  MemoryZeroStruct(document);
+}
+
+internal Document_Damage document_edit(Document* document, Document_Edit edit) {
+  Document_Damage result = {0};
+  u64 size = document->file.data.size;
+  edit.offset       = (u32)Min((u64)edit.offset, size);
+  edit.removed_size = (u32)Min((u64)edit.removed_size, size - edit.offset);
+  Assert(size - edit.removed_size + edit.inserted.size < U32_MAX); // Offsets are 32 bit
+  if (!document_fits(document, size - edit.removed_size + edit.inserted.size)) {
+    result = document_reopen(document, edit);
+    return result;
+  }
+
+  u64 tokens_count = document->parser.tokens.count;
+  document_splice_source(document, edit);
+  document_splice_lines(document, edit);
+
+  u64 old_end     = 0;
+  u64 first_token = document_relex(document, edit, &old_end, &result);
+  s64 token_delta = (s64)document->parser.tokens.count - (s64)tokens_count;
+  document_reparse(document, first_token, old_end, token_delta, edit, &result);
+  return result;
+}
+
+internal b32 document_fits(Document* document, u64 size) {
+  b32 result = (size <= document->size_limit);
+  return result;
+}
+
+internal u64 document_arena_reserve(u64 size) {
+  u64 result = DOCUMENT_ARENA_MIN_RESERVE + size * DOCUMENT_ARENA_BYTES_PER_BYTE;
+  return result;
+}
+
+internal Document_Damage document_reopen(Document* document, Document_Edit edit) {
+  // NOTE(fz): Outgrew the arenas. Opened again with the edit applied, a whole re-lex and re-parse like the first open.
+  Arena_Temp scratch = scratch_begin(0, 0);
+  String8 old_source = document->file.data;
+  String8 source     = {0};
+  source.size = old_source.size - edit.removed_size + edit.inserted.size;
+  source.str  = ArenaPushNoZero(scratch.arena, char8, source.size);
+  MemoryCopy(source.str, old_source.str, edit.offset);
+  if (edit.inserted.size > 0) {
+    MemoryCopy(source.str + edit.offset, edit.inserted.str, edit.inserted.size);
+  }
+  MemoryCopy(source.str + edit.offset + edit.inserted.size, old_source.str + edit.offset + edit.removed_size, old_source.size - edit.offset - edit.removed_size);
+
+  Lexer_Flags flags = document->flags;
+  document_close(document);
+  document_open(document, source, flags);
+  scratch_end(&scratch);
+
+  Document_Damage result = {0};
+  result.tokens_lexed    = (u32)document->parser.tokens.count;
+  result.segments_parsed = (u32)document->segments_count;
+  return result;
+}
+
+internal void document_splice_source(Document* document, Document_Edit edit) {
+  String8* source = &document->file.data;
+  u64 size = source->size - edit.removed_size + edit.inserted.size;
+
+  source->str = document_reserve(document->source_arena, source->str, &document->source_capacity, size, sizeof(char8));
+  document_replace(source->str, sizeof(char8), source->size, edit.offset, edit.offset + edit.removed_size, edit.inserted.str, edit.inserted.size);
+  source->size = size;
+  document->parser.tokens.source = *source;
+}
+
+internal void document_splice_lines(Document* document, Document_Edit edit) {
+  Line_Index* lines = &document->parser.tokens.lines;
+  String8 source    = document->file.data; // Already spliced
+  u32 removed_end   = edit.offset + edit.removed_size;
+  s64 delta         = (s64)edit.inserted.size - (s64)edit.removed_size;
+
+  // NOTE(fz): Whether a '\r' breaks a line depends on the byte after it, so the byte before the edit is scanned again
+  // with the inserted ones. The first kept byte is scanned only so the last inserted one sees what follows it.
+  u32 start = (edit.offset > 0) ? edit.offset - 1 : 0;
+  u32 end   = edit.offset + (u32)edit.inserted.size;
+  u64 first = document_line_after(lines, start);
+  u64 last  = document_line_after(lines, removed_end);
+  for (u64 i = last; i < lines->count; i += 1) {
+    lines->offsets[i] = (u32)(lines->offsets[i] + delta);
+  }
+
+  Arena_Temp scratch = scratch_begin(0, 0);
+  String8 window = string8_slice(source, start, Min((u64)end + 1, source.size));
+  u32* inserted  = ArenaPushNoZero(scratch.arena, u32, window.size);
+  u64 count      = scan_newlines(window, inserted);
+  if (count > 0 && inserted[count - 1] >= end - start) {
+    count -= 1;
+  }
+  for (u64 i = 0; i < count; i += 1) {
+    inserted[i] += start;
+  }
+
+  u64 lines_count = lines->count - (last - first) + count;
+  lines->offsets  = document_reserve(document->lines_arena, lines->offsets, &document->lines_capacity, lines_count, sizeof(u32));
+  document_replace(lines->offsets, sizeof(u32), lines->count, first, last, inserted, count);
+  lines->count = lines_count;
+  scratch_end(&scratch);
+}
+
+internal u64 document_relex(Document* document, Document_Edit edit, u64* old_end, Document_Damage* damage) {
+  Token_Array* tokens = &document->parser.tokens;
+  u32 inserted_end    = edit.offset + (u32)edit.inserted.size;
+  s64 delta           = (s64)edit.inserted.size - (s64)edit.removed_size;
+
+  // NOTE(fz): A token can decide its end by looking one byte past it, so lexing starts a token before the one the edit begins in.
+  u64 first = document_token_before(tokens->tokens, tokens->count, edit.offset);
+  if (first > 0) {
+    first -= 1;
+  }
+  Token start = tokens->tokens[first];
+
+  Arena_Temp scratch = scratch_begin(0, 0);
+  Lexer lexer;
+  lexer_init_at(&lexer, tokens->source, document->flags, start.start_offset - document_is_literal(start));
+
+  Token* list  = ArenaPushNoZero(scratch.arena, Token, TOKEN_CHUNK_SIZE);
+  u64 capacity = TOKEN_CHUNK_SIZE;
+  u64 count    = 0;
+  u64 old      = first;
+  u64 end      = tokens->count; // Every old token from first on, unless the lexer lines up
+  for (;;) {
+    Token token = next_token(&lexer);
+
+    // Lexing is a function of where a token starts and the bytes from there on. Past the edit the bytes are the old ones,
+    // so once a new token starts where an old token did the rest of the old tokens are what lexing would produce.
+    if (token.type != Token_End_Of_File && token.start_offset >= inserted_end && !document_is_literal(token)) {
+      u32 target = (u32)((s64)token.start_offset - delta); // Old tokens still hold old offsets
+      while (old < tokens->count && tokens->tokens[old].start_offset < target) {
+        old += 1;
+      }
+      Token* candidate = &tokens->tokens[old];
+      if (old < tokens->count && candidate->start_offset == target && candidate->type == token.type && !document_is_literal(*candidate)) {
+        end = old;
+        break;
+      }
+    }
+
+    if (count == capacity) {
+      Token* chunk = ArenaPushNoZero(scratch.arena, Token, TOKEN_CHUNK_SIZE);
+      Assert(chunk == list + capacity);
+      capacity += TOKEN_CHUNK_SIZE;
+    }
+    list[count] = token;
+    count += 1;
+    if (token.type == Token_End_Of_File) {
+      break;
+    }
+  }
+
+  for (u64 i = end; i < tokens->count; i += 1) {
+    tokens->tokens[i].start_offset = (u32)(tokens->tokens[i].start_offset + delta);
+  }
+  u64 tokens_count = tokens->count - (end - first) + count;
+  tokens->tokens   = document_reserve(document->tokens_arena, tokens->tokens, &document->tokens_capacity, tokens_count, sizeof(Token));
+  document_replace(tokens->tokens, sizeof(Token), tokens->count, first, end, list, count);
+  tokens->count = tokens_count;
+  scratch_end(&scratch);
+
+  damage->tokens_lexed = (u32)count;
+  *old_end = end;
+  return first;
+}
+
+internal void document_reparse(Document* document, u64 first_token, u64 old_end, s64 token_delta, Document_Edit edit, Document_Damage* damage) {
+  Parser* parser = &document->parser;
+  AST* ast       = &parser->ast;
+  u32 removed_end = edit.offset + edit.removed_size;
+  s64 delta       = (s64)edit.inserted.size - (s64)edit.removed_size;
+
+  // Last segment starting at or before the first re-lexed token, then one more back since the parser looks ahead
+  Document_Segment* segments = document->segments;
+  u64 segments_count = document->segments_count;
+  u64 low  = 0;
+  u64 high = segments_count;
+  while (low < high) {
+    u64 middle = low + (high - low) / 2;
+    if (segments[middle].token <= first_token) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  u64 restart = (low > 1) ? low - 2 : 0;
+  Document_Segment start = segments[restart];
+
+  AST_Index nodes_count = ast->count;
+  u32 trivia_count      = ast->trivia_count;
+  u32 errors_count      = parser->errors_count;
+  AST_Node* root        = ASTNode(ast, ast->root);
+  AST_Index last_item   = root->last_child;
+
+  // Cut the root's children back to the construct before the restart
+  AST_Index previous_item = AST_NULL;
+  for (u64 i = restart; i > 0 && previous_item == AST_NULL; i -= 1) {
+    previous_item = segments[i - 1].item;
+  }
+  root->last_child = previous_item;
+  if (previous_item == AST_NULL) {
+    root->first_child = AST_NULL;
+  } else {
+    ASTNode(ast, previous_item)->next_sibling = AST_NULL;
+  }
+
+  // NOTE(fz): Typedefs from the restart on are forgotten, parsing there must only see the ones declared before it.
+  Arena_Temp scratch   = scratch_begin(0, 0);
+  AST_Index* forgotten = ArenaPushNoZero(scratch.arena, AST_Index, parser->typedef_capacity);
+  u32 forgotten_count  = document_typedefs_forget(parser, start.node, forgotten);
+
+  parser->index         = start.token;
+  parser->previous_end  = start.previous_end;
+  parser->previous_type = start.previous_type;
+  parser->is_recovering = false;
+
+  // New nodes, trivia, errors and segments are appended past the old ones, then moved into place. The old trivia keeps its nodes
+  ast->trivia_pending = ast->trivia_count;
+  u64 candidate = restart + 1;
+  while (candidate + 1 < segments_count && segments[candidate].token < old_end) {
+    candidate += 1;
+  }
+  u64 added_count = 0;
+  b32 lined_up    = false;
+  for (;;) {
+    if (added_count > 0) {
+      while (candidate + 1 < segments_count && (s64)segments[candidate].token + token_delta < (s64)parser->index) {
+        candidate += 1;
+      }
+      // Same token, same state and no typedef added or removed on either side: the old segments from here on still hold
+      Document_Segment* old = &segments[candidate];
+      lined_up = (candidate + 1 < segments_count &&
+                  (s64)old->token + token_delta == (s64)parser->index &&
+                  old->typedef_count    == start.typedef_count &&
+                  parser->typedef_count == start.typedef_count &&
+                  old->previous_type    == parser->previous_type &&
+                  document_shift(old->previous_end, removed_end, delta) == parser->previous_end);
+      if (lined_up) {
+        break;
+      }
+    }
+
+    segments = document_reserve(document->segments_arena, segments, &document->segments_capacity, segments_count + added_count + 1, sizeof(Document_Segment));
+    Document_Segment* segment = &segments[segments_count + added_count];
+    document_record(parser, segment);
+    added_count += 1;
+
+    Token* current = parser_skip_trivia(parser);
+    if (current->type == Token_End_Of_File) {
+      break;
+    }
+    segment->item = parse_top_level(parser);
+    damage->segments_parsed += 1;
+  }
+
+  u64 kept     = lined_up ? candidate : segments_count;
+  AST_Index node_end = lined_up ? segments[kept].node   : nodes_count;
+  u32 trivia_end     = lined_up ? segments[kept].trivia : trivia_count;
+  u32 error_end      = lined_up ? segments[kept].error  : errors_count;
+
+  u32 added_nodes  = ast->count - nodes_count;
+  u32 added_trivia = ast->trivia_count - trivia_count;
+  u32 added_errors = parser->errors_count - errors_count;
+  s64 node_delta   = (s64)added_nodes  - (s64)(node_end - start.node);
+  s64 trivia_delta = (s64)added_trivia - (s64)(trivia_end - start.trivia);
+  s64 error_delta  = (s64)added_errors - (s64)(error_end - start.error);
+
+  // Nodes. New ones only link to each other, kept ones only to kept ones.
+  for (AST_Index i = nodes_count; i < ast->count; i += 1) {
+    AST_Node* node = ASTNode(ast, i);
+    node->first_child  = document_relocate(node->first_child, nodes_count, start.node);
+    node->last_child   = document_relocate(node->last_child, nodes_count, start.node);
+    node->next_sibling = document_relocate(node->next_sibling, nodes_count, start.node);
+  }
+  for (AST_Index i = node_end; i < nodes_count; i += 1) {
+    AST_Node* node = ASTNode(ast, i);
+    node->start_offset = document_shift(node->start_offset, removed_end, delta);
+    node->end_offset   = document_shift(node->end_offset, removed_end, delta);
+    if (node->first_child  != AST_NULL) node->first_child  = (AST_Index)(node->first_child  + node_delta);
+    if (node->last_child   != AST_NULL) node->last_child   = (AST_Index)(node->last_child   + node_delta);
+    if (node->next_sibling != AST_NULL) node->next_sibling = (AST_Index)(node->next_sibling + node_delta);
+  }
+  AST_Node* added_nodes_copy = ArenaPushNoZero(scratch.arena, AST_Node, added_nodes);
+  MemoryCopy(added_nodes_copy, ASTNode(ast, nodes_count), added_nodes * sizeof(AST_Node));
+  document_replace(ast->nodes, sizeof(AST_Node), nodes_count, start.node, node_end, added_nodes_copy, added_nodes);
+  ast->count = (AST_Index)(nodes_count + node_delta);
+
+  root = ASTNode(ast, ast->root);
+  root->first_child = document_relocate(root->first_child, nodes_count, start.node);
+  root->last_child  = document_relocate(root->last_child, nodes_count, start.node);
+  if (previous_item != AST_NULL) {
+    AST_Node* previous = ASTNode(ast, previous_item);
+    previous->next_sibling = document_relocate(previous->next_sibling, nodes_count, start.node);
+  }
+  if (lined_up) {
+    AST_Index first_kept = AST_NULL;
+    for (u64 i = kept; i < segments_count && first_kept == AST_NULL; i += 1) {
+      first_kept = segments[i].item;
+    }
+    if (first_kept != AST_NULL) {
+      first_kept = (AST_Index)(first_kept + node_delta);
+      if (root->last_child == AST_NULL) {
+        root->first_child = first_kept;
+      } else {
+        ASTNode(ast, root->last_child)->next_sibling = first_kept;
+      }
+      root->last_child = (AST_Index)(last_item + node_delta);
+    }
+  }
+
+  // Trivia
+  for (u32 i = trivia_count; i < ast->trivia_count; i += 1) {
+    ast->trivia[i].node = document_relocate(ast->trivia[i].node, nodes_count, start.node);
+  }
+  for (u32 i = trivia_end; i < trivia_count; i += 1) {
+    ast->trivia[i].token_index = (u32)(ast->trivia[i].token_index + token_delta);
+    ast->trivia[i].node        = (AST_Index)(ast->trivia[i].node + node_delta);
+  }
+  AST_Trivia* added_trivia_copy = ArenaPushNoZero(scratch.arena, AST_Trivia, added_trivia);
+  MemoryCopy(added_trivia_copy, ast->trivia + trivia_count, added_trivia * sizeof(AST_Trivia));
+  document_replace(ast->trivia, sizeof(AST_Trivia), trivia_count, start.trivia, trivia_end, added_trivia_copy, added_trivia);
+  ast->trivia_count = (u32)(trivia_count + trivia_delta);
+
+  // Errors
+  for (u32 i = error_end; i < errors_count; i += 1) {
+    parser->errors[i].start_offset = document_shift(parser->errors[i].start_offset, removed_end, delta);
+    parser->errors[i].end_offset   = document_shift(parser->errors[i].end_offset, removed_end, delta);
+  }
+  Parser_Error* added_errors_copy = ArenaPushNoZero(scratch.arena, Parser_Error, added_errors);
+  MemoryCopy(added_errors_copy, parser->errors + errors_count, added_errors * sizeof(Parser_Error));
+  document_replace(parser->errors, sizeof(Parser_Error), errors_count, start.error, error_end, added_errors_copy, added_errors);
+  parser->errors_count = (u32)(errors_count + error_delta);
+
+  // Segments
+  for (u64 i = segments_count; i < segments_count + added_count; i += 1) {
+    Document_Segment* segment = &segments[i];
+    segment->node   = document_relocate(segment->node, nodes_count, start.node);
+    segment->item   = document_relocate(segment->item, nodes_count, start.node);
+    segment->trivia = segment->trivia - trivia_count + start.trivia;
+    segment->error  = segment->error - errors_count + start.error;
+  }
+  for (u64 i = kept; i < segments_count; i += 1) {
+    Document_Segment* segment = &segments[i];
+    segment->token        = (u32)(segment->token + token_delta);
+    segment->node         = (AST_Index)(segment->node + node_delta);
+    segment->trivia       = (u32)(segment->trivia + trivia_delta);
+    segment->error        = (u32)(segment->error + error_delta);
+    segment->previous_end = document_shift(segment->previous_end, removed_end, delta);
+    if (segment->item != AST_NULL) {
+      segment->item = (AST_Index)(segment->item + node_delta);
+    }
+  }
+  Document_Segment* added_segments_copy = ArenaPushNoZero(scratch.arena, Document_Segment, added_count);
+  MemoryCopy(added_segments_copy, segments + segments_count, added_count * sizeof(Document_Segment));
+  document_replace(segments, sizeof(Document_Segment), segments_count, restart, kept, added_segments_copy, added_count);
+  document->segments       = segments;
+  document->segments_count = restart + added_count + (segments_count - kept);
+
+  // Typedefs. Ones declared in the re-parsed segments were stored with new indices, forgotten ones come back if they were kept.
+  for (u32 i = 0; i < parser->typedef_capacity; i += 1) {
+    parser->typedef_names[i] = document_relocate(parser->typedef_names[i], nodes_count, start.node);
+  }
+  if (lined_up) {
+    for (u32 i = 0; i < forgotten_count; i += 1) {
+      parser_typedef_add(parser, (AST_Index)(forgotten[i] + node_delta));
+    }
+  }
+
+  scratch_end(&scratch);
+}
+
+internal void document_record(Parser* parser, Document_Segment* segment) {
+  segment->token         = (u32)parser->index;
+  segment->node          = parser->ast.count;
+  segment->trivia        = parser->ast.trivia_count;
+  segment->error         = parser->errors_count;
+  segment->typedef_count = parser->typedef_count;
+  segment->previous_end  = parser->previous_end;
+  segment->previous_type = parser->previous_type;
+  segment->item          = AST_NULL;
+}
+
+internal u32 document_typedefs_forget(Parser* parser, AST_Index from, AST_Index* forgotten) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  AST_Index* kept    = ArenaPushNoZero(scratch.arena, AST_Index, parser->typedef_capacity);
+  u32 kept_count = 0;
+  u32 result     = 0;
+  for (u32 i = 0; i < parser->typedef_capacity; i += 1) {
+    AST_Index name = parser->typedef_names[i];
+    if (name == AST_NULL) {
+      continue;
+    }
+    if (name < from) {
+      kept[kept_count] = name;
+      kept_count += 1;
+    } else {
+      forgotten[result] = name;
+      result += 1;
+    }
+  }
+
+  // Open addressing can't remove in place, the table is rebuilt at the same size
+  MemoryZero(parser->typedef_names, parser->typedef_capacity * sizeof(AST_Index));
+  MemoryZero(parser->typedef_ids, parser->typedef_capacity * sizeof(Intern_Id));
+  parser->typedef_count = 0;
+  for (u32 i = 0; i < kept_count; i += 1) {
+    parser_typedef_add(parser, kept[i]);
+  }
+  scratch_end(&scratch);
+  return result;
+}
+
+///////////////
+// Help
+internal void* document_reserve(Arena* arena, void* base, u64* capacity, u64 count, u64 element_size) {
+  if (count > *capacity) {
+    u64 grow  = AlignPow2(count - *capacity, DOCUMENT_CHUNK_SIZE);
+    u8* chunk = (u8*)arena_push_no_zero(arena, grow * element_size);
+    if (*capacity == 0) {
+      base = chunk;
+    }
+    Assert(chunk == (u8*)base + *capacity * element_size);
+    *capacity += grow;
+  }
+  return base;
+}
+
+internal void document_replace(void* base, u64 element_size, u64 count, u64 start, u64 end, void* replacement, u64 replacement_count) {
+  u8* bytes = (u8*)base;
+  if (end - start != replacement_count) {
+    MemoryMove(bytes + (start + replacement_count) * element_size, bytes + end * element_size, (count - end) * element_size);
+  }
+  if (replacement_count > 0) {
+    MemoryCopy(bytes + start * element_size, replacement, replacement_count * element_size);
+  }
+}
+
+internal u64 document_token_before(Token* tokens, u64 count, u32 offset) {
+  // First token starting at or after offset, the answer is the one before it
+  u64 low  = 0;
+  u64 high = count;
+  while (low < high) {
+    u64 middle = low + (high - low) / 2;
+    if (tokens[middle].start_offset < offset) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  u64 result = (low > 0) ? low - 1 : 0;
+  return result;
+}
+
+internal u64 document_line_after(Line_Index* lines, u32 offset) {
+  u64 low  = 0;
+  u64 high = lines->count;
+  while (low < high) {
+    u64 middle = low + (high - low) / 2;
+    if (lines->offsets[middle] < offset) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+internal b32 document_is_literal(Token token) {
+  b32 result = (token.type == Token_String_Literal || token.type == Token_Char_Literal);
+  return result;
+}
+
+internal AST_Index document_relocate(AST_Index index, AST_Index old_count, AST_Index start) {
+  AST_Index result = (index >= old_count) ? index - old_count + start : index;
+  return result;
+}
+
+internal u32 document_shift(u32 offset, u32 old_end, s64 delta) {
+  u32 result = (offset >= old_end) ? (u32)(offset + delta) : offset;
+  return result;
+}
@@ -0,0 +1,86 @@
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+// DOC(fz): A source file kept in memory and edited in place, for editors that re-analyze on every keystroke.
+// An edit re-lexes from just before the edited bytes until the new tokens line up with the old ones again, then
+// re-parses from the top level construct before the damage until the parser reaches an old construct boundary in
+// the same state. Everything past that point is kept and only has its offsets and indices shifted. The arrays stay
+// flat and in source order, so the Parser of a document looks exactly like one that parsed the whole file.
+//
+// Each iteration of the top level loop is a segment. Its boundary is the parser state the loop starts from, and the
+// segments are what a re-parse restarts from and stops at. A boundary is only reused when no typedef was added or
+// removed in between, a typedef changes how everything after it parses.
+
+typedef struct Document_Edit {
+  u32 offset;       // Into the current source
+  u32 removed_size; // Bytes removed at offset
+  String8 inserted; // Bytes inserted at offset
+} Document_Edit;
+
+typedef struct Document_Segment {
+  u32 token;                // Index of the first token, the parser's index at the top of the loop
+  AST_Index node;           // ast.count at the top of the loop, the first node the segment creates
+  u32 trivia;               // trivia_count at the top of the loop
+  u32 error;                // errors_count at the top of the loop
+  u32 typedef_count;
+  u32 previous_end;
+  Token_Type previous_type;
+  AST_Index item;           // Top level construct the segment produced, AST_NULL for stray tokens
+} Document_Segment;
+
+// How much of the file the last edit touched
+typedef struct Document_Damage {
+  u32 tokens_lexed;    // New tokens produced before the lexer lined up again
+  u32 segments_parsed; // Top level constructs parsed again
+} Document_Damage;
+
+typedef struct Document {
+  Lexer_Flags flags;
+  File_Data file; // data is the current source
+
+  // NOTE(fz): Each array lives alone in its arena and grows in chunks in place, so edits move elements but never the array.
+  // The arenas, the parser's included, are resident ones of arena_reserve bytes each, picked from the size the document
+  // was opened at, so thousands of open documents fit the address space and the mapping limit.
+  u64 size_limit;    // Largest source the arenas were reserved for, document_edit opens the document again past it
+  u64 arena_reserve;
+  Arena* source_arena;
+  u64 source_capacity;
+  Arena* tokens_arena; // parser.tokens.tokens
+  u64 tokens_capacity;
+  Arena* lines_arena;  // parser.tokens.lines.offsets
+  u64 lines_capacity;
+  Arena* segments_arena;
+  Document_Segment* segments; // The last one is the boundary at End_Of_File
+  u64 segments_count;
+  u64 segments_capacity;
+
+  Parser parser; // Its Token_Array points into the arrays above
+} Document;
+#define DOCUMENT_CHUNK_SIZE 4096 // Elements grown at a time, for every array
+#define DOCUMENT_ARENA_BYTES_PER_BYTE 512 // Reserved per source byte, far past what tokens, nodes and an edit in flight take for one
+#define DOCUMENT_ARENA_MIN_RESERVE    Megabytes(1)
+#define DOCUMENT_MIN_SIZE_LIMIT       Kilobytes(16) // An empty or tiny document still takes a few screens of typing before it is opened again
+
+internal void            document_open(Document* document, String8 source, Lexer_Flags flags); /* Copies source, lexes and parses it whole */
+internal void            document_close(Document* document);
+internal Document_Damage document_edit(Document* document, Document_Edit edit); /* Applies edit and brings tokens, lines and the AST up to date. Opens the document again if it outgrows size_limit */
+internal b32             document_fits(Document* document, u64 size);           /* False if a source of size is past size_limit, an edit to it opens the document again */
+internal u64             document_arena_reserve(u64 size);                      /* Reserve for each arena of a document that may grow to size */
+
+// Help
+internal Document_Damage document_reopen(Document* document, Document_Edit edit); /* Closes and opens the document with edit applied */
+internal void*     document_reserve(Arena* arena, void* base, u64* capacity, u64 count, u64 element_size); /* Grows the array alone in arena until count fits, returns its base */
+internal void      document_replace(void* base, u64 element_size, u64 count, u64 start, u64 end, void* replacement, u64 replacement_count); /* [start, end) becomes replacement, room must be reserved */
+internal void      document_splice_source(Document* document, Document_Edit edit);
+internal void      document_splice_lines(Document* document, Document_Edit edit);
+internal u64       document_relex(Document* document, Document_Edit edit, u64* old_end, Document_Damage* damage); /* Returns the first re-lexed token, old_end is the first old token kept */
+internal void      document_reparse(Document* document, u64 first_token, u64 old_end, s64 token_delta, Document_Edit edit, Document_Damage* damage);
+internal void      document_record(Parser* parser, Document_Segment* segment);                  /* Boundary of the segment starting at the parser's state */
+internal u32       document_typedefs_forget(Parser* parser, AST_Index from, AST_Index* forgotten); /* Drops typedef names at node from or later into forgotten, returns how many */
+internal u64       document_token_before(Token* tokens, u64 count, u32 offset);                 /* Last token starting before offset, 0 if none */
+internal u64       document_line_after(Line_Index* lines, u32 offset);                          /* First line break at or after offset */
+internal b32       document_is_literal(Token token);                                            /* Starts one byte past where the lexer began it */
+internal AST_Index document_relocate(AST_Index index, AST_Index old_count, AST_Index start);     /* Index appended past old_count to where it is moved at start */
+internal u32       document_shift(u32 offset, u32 old_end, s64 delta);                          /* Moves offsets past the edited bytes */
+
+#endif // DOCUMENT_H
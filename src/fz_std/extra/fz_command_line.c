@@ -50,9 +50,7 @@ internal String8 command_line_parse_token(char8** cursor) {
 internal Command_Line command_line_parse(String8 input) {
   Command_Line result = {0};
 
-  static char8 exe_buffer[MAX_PATH];
-  DWORD exe_len = GetModuleFileNameA(0, exe_buffer, MAX_PATH);
-  result.executable = (String8){ exe_len, exe_buffer };
+  result.executable = path_get_executable();
 
   // Copy input into stable memory
   static char8 temp_buffer[TEMP_BUFFER_SIZE];
@@ -109,4 +107,28 @@ internal Command_Line command_line_parse(String8 input) {
   }
 
   return result;
-}
\ No newline at end of file
+}
+
+internal String8 command_line_join(s32 argc, char8** argv) {
+  static char8 joined_buffer[TEMP_BUFFER_SIZE];
+  u64 cursor = 0;
+
+  for (s32 i = 1; i < argc; i += 1) {
+    String8 arg = string8_from_cstring(argv[i]);
+    b32 quote   = false;
+    for (u64 j = 0; j < arg.size; j += 1) {
+      if (arg.str[j] == ' ') quote = true;
+    }
+    u64 needed  = arg.size + (quote ? 2 : 0) + 1;
+    if (cursor + needed >= sizeof(joined_buffer)) break;
+
+    if (cursor > 0)  joined_buffer[cursor++] = ' ';
+    if (quote)       joined_buffer[cursor++] = '"';
+    MemoryCopy(joined_buffer + cursor, arg.str, arg.size);
+    cursor += arg.size;
+    if (quote)       joined_buffer[cursor++] = '"';
+  }
+
+  joined_buffer[cursor] = 0;
+  return string8_new(cursor, joined_buffer);
+}
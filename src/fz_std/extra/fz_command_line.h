@@ -27,6 +27,7 @@ typedef struct Command_Line {
 } Command_Line;
 
 internal Command_Line command_line_parse(String8 lpCmdLine);
+internal String8      command_line_join(s32 argc, char8** argv); /* Joins argv[1..argc) back into one command line, for platforms that start from main() */
 internal String8      command_line_parse_token(char8** cursor);
 internal void         command_line_skip_whitespace(char8** cursor);
 internal String8      command_line_strip_quotes(String8 in);
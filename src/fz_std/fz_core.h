@@ -295,9 +295,46 @@
 #define global        static
 #define internal      static
 
+////////////////////////////////
+// Atomics
+// NOTE(fz): All of these are full barriers. Exchange and compare exchange return the previous value.
+
+#if COMPILER_MSVC
+# include <intrin.h>
+# define atomic_load_u32(x)                 ((u32)_InterlockedOr((volatile long*)(x), 0))
+# define atomic_load_u64(x)                 ((u64)_InterlockedOr64((volatile __int64*)(x), 0))
+# define atomic_store_u32(x,v)              ((void)_InterlockedExchange((volatile long*)(x), (long)(v)))
+# define atomic_exchange_u32(x,v)           ((u32)_InterlockedExchange((volatile long*)(x), (long)(v)))
+# define atomic_compare_exchange_u32(x,e,v) ((u32)_InterlockedCompareExchange((volatile long*)(x), (long)(v), (long)(e)))
+# define atomic_add_u64(x,v)                ((u64)_InterlockedExchangeAdd64((volatile __int64*)(x), (__int64)(v)) + (u64)(v))
+# define atomic_increment_u64(x)            ((u64)_InterlockedIncrement64((volatile __int64*)(x)))
+# define atomic_decrement_u64(x)            ((u64)_InterlockedDecrement64((volatile __int64*)(x)))
+# define cpu_pause()                        _mm_pause()
+#elif COMPILER_CLANG || COMPILER_GCC
+# define atomic_load_u32(x)                 __atomic_load_n((x), __ATOMIC_SEQ_CST)
+# define atomic_load_u64(x)                 __atomic_load_n((x), __ATOMIC_SEQ_CST)
+# define atomic_store_u32(x,v)              __atomic_store_n((x), (v), __ATOMIC_SEQ_CST)
+# define atomic_exchange_u32(x,v)           __atomic_exchange_n((x), (v), __ATOMIC_SEQ_CST)
+# define atomic_compare_exchange_u32(x,e,v) __sync_val_compare_and_swap((x), (e), (v))
+# define atomic_add_u64(x,v)                __atomic_add_fetch((x), (v), __ATOMIC_SEQ_CST)
+# define atomic_increment_u64(x)            __atomic_add_fetch((x), 1, __ATOMIC_SEQ_CST)
+# define atomic_decrement_u64(x)            __atomic_sub_fetch((x), 1, __ATOMIC_SEQ_CST)
+# if ARCH_X64 || ARCH_X86
+#  define cpu_pause()                       __builtin_ia32_pause()
+# else
+#  define cpu_pause()                       ((void)0)
+# endif
+#else
+# error Atomics are not defined for this compiler.
+#endif
+
 ////////////////////////////////
 // Types 
 
+#if defined(__STDC_UTF_16__) || defined(__STDC_UTF_32__)
+# include <uchar.h>
+#endif
+
 #if defined(__STDC_UTF_8__)
 typedef char8_t char8;
 #else
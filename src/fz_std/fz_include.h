@@ -3,24 +3,36 @@
 
 //~ CLib
 // TODO(fz): We want to replace these
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+# define _GNU_SOURCE
+#endif
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include <math.h>
 
+//~ Single headers
+#include "fz_core.h"
+
+// NOTE(fz): Headless builds skip the window, OpenGL and font/image layers. Linux is headless only.
+#if !defined(FZ_HEADLESS)
+# define FZ_HEADLESS OS_LINUX
+#endif
+
 //~ Extern
 #define STB_SPRINTF_STATIC
 #define STB_SPRINTFZ_IMPLEMENTATION
 #include "external/stb_sprintf.h"
-#define STBTT_STATIC
-#define STB_TRUETYPE_IMPLEMENTATION
-#include "external/stb_truetype.h"
-#define STB_IMAGE_STATIC
-#define STB_IMAGE_IMPLEMENTATION
-#include "external/stb_image.h"
+#if !FZ_HEADLESS
+# define STBTT_STATIC
+# define STB_TRUETYPE_IMPLEMENTATION
+# include "external/stb_truetype.h"
+# define STB_IMAGE_STATIC
+# define STB_IMAGE_IMPLEMENTATION
+# include "external/stb_image.h"
+#endif
 
-//~ Single headers
-#include "fz_core.h"
-#include "fz_io.h" // TODO(fz): This is actually OS dependent 
+#include "fz_io.h" // TODO(fz): This is actually OS dependent
 
 //~ Headers
 #include "fz_math.h"
@@ -29,16 +41,25 @@
 #include "fz_thread_context.h"
 #include "fz_command_line.h"
 
+//~ OS
+#include "fz_os.h"
+#if OS_WINDOWS
+# include "fz_win32.h"
+#elif OS_LINUX
+# include "fz_linux.h"
+#endif
+#include "fz_thread_pool.h"
+
+#if !FZ_HEADLESS
 //~ Opengl specific headers
-#include "glad/glad.h"
-#include "glad/glad.c"
-#include "extra/fz_opengl_helper.h"
+# include "glad/glad.h"
+# include "glad/glad.c"
+# include "extra/fz_opengl_helper.h"
 
 //~ Window application
-#include "fz_input.h"
-
-#include "fz_win32.h"
-#include "fz_win32_window.h"
+# include "fz_input.h"
+# include "fz_win32_window.h"
+#endif
 
 //~ Source
 #include "fz_math.c"
@@ -47,13 +68,22 @@
 #include "fz_thread_context.c"
 #include "fz_command_line.c"
 
+//~ OS
+#include "fz_os.c"
+#if OS_WINDOWS
+# include "fz_win32.c"
+#elif OS_LINUX
+# include "fz_linux.c"
+#endif
+#include "fz_thread_pool.c"
+
+#if !FZ_HEADLESS
 //~ Opengl specific implementation
-#include "extra/fz_opengl_helper.c"
+# include "extra/fz_opengl_helper.c"
 
 //~ Window application
 # include "fz_input.c"
+# include "fz_win32_window.c"
+#endif
 
-#include "fz_win32.c"
-#include "fz_win32_window.c"
-
-#endif // FZ_INCLUDES_H
\ No newline at end of file
+#endif // FZ_INCLUDES_H
@@ -6,6 +6,7 @@
 
 #define Degrees(r) (r * (180 / PI))
 #define Radians(d) (d * (PI / 180))
+#define FloatEquals(a,b) (f32_abs((a) - (b)) < EPSILON)
 
 typedef struct Vec2f32 {
     union {
@@ -34,6 +34,19 @@ internal Arena* arena_init_sized(u64 reserve, u64 commit) {
   return arena;
 }
 
+internal Arena* arena_init_resident(u64 reserve) {
+  // NOTE(fz): Linux limits how many mappings a process has (vm.max_map_count, 65530 by default). An arena committed in
+  // steps is two of them, the committed start and the reserved rest, and never merges with the next arena. Committed
+  // whole it is one mapping that merges with its neighbours, and its pages still cost nothing until touched.
+  // Windows has no such limit and charges commit up front, so there it commits in steps like any arena.
+#if OS_LINUX
+  Arena* arena = arena_init_sized(reserve, reserve);
+#else
+  Arena* arena = arena_init_sized(reserve, ARENA_COMMIT_SIZE);
+#endif
+  return arena;
+}
+
 internal void* arena_push(Arena* arena, u64 size) {
   void* result = arena_push_no_zero(arena, size);
   MemoryZero(result, size);
@@ -86,7 +99,7 @@ internal void  arena_pop_to(Arena* arena, u64 pos) {
 }
 
 internal void  arena_clear(Arena* arena) {
-  arena_pop(arena, arena->position);
+  arena_pop_to(arena, ARENA_HEADER_SIZE); // The header lives at the start of the arena's own memory
 }
 
 internal void  arena_free(Arena* arena) {
@@ -20,6 +20,7 @@ typedef struct Arena {
 
 internal Arena* arena_init();
 internal Arena* arena_init_sized(u64 reserve, u64 commit);
+internal Arena* arena_init_resident(u64 reserve); /* For many arenas that live long side by side, see the note in it */
 
 internal void* arena_push(Arena* arena, u64 size);
 internal void* arena_push_no_zero(Arena* arena, u64 size);
@@ -0,0 +1,149 @@
+// DOC(fz): Platform independent part of fz_os.h, paths are plain string work once the separator is known.
+
+internal b32 file_has_extension(String8 filename, String8 ext) {
+  if (filename.size < ext.size + 1)  return false;
+  if (filename.str[filename.size - ext.size] != '.')  return false;
+  for (u64 i = 0; i < ext.size; i++) {
+    if (char8_to_lower(filename.str[filename.size - ext.size + i]) != char8_to_lower(ext.str[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+internal String8_List file_get_all_file_paths_recursively(Arena* arena, String8 path) {
+  String8_List result = {0};
+  if (!path_is_directory(path)) {
+    printf("Path '%.*s' is not a directory.\n", (s32)path.size, path.str);
+    return result;
+  }
+
+  Arena_Temp scratch = scratch_begin(&arena, 1);
+  String8_List queue = {0};
+  string8_list_push(scratch.arena, &queue, path_new(scratch.arena, path));
+  _File_Paths_Walk walk = { arena, scratch.arena, &result, &queue };
+  while (queue.node_count > 0) {
+    directory_visit(string8_list_pop(&queue), _file_paths_visit, &walk);
+  }
+
+  scratch_end(&scratch);
+  return result;
+}
+
+internal void _file_paths_visit(String8 directory_path, String8 name, b32 is_directory, void* context) {
+  _File_Paths_Walk* walk = (_File_Paths_Walk*)context;
+  if (is_directory) {
+    string8_list_push(walk->scratch, walk->queue, path_join(walk->scratch, directory_path, name));
+  } else {
+    string8_list_push(walk->arena, walk->result, path_join(walk->arena, directory_path, name));
+  }
+}
+
+internal String8 path_new(Arena* arena, String8 input) {
+  char8* data = ArenaPush(arena, char8, input.size);
+  for (u64 i = 0; i < input.size; i++) {
+    char8 c = input.str[i];
+    data[i] = (c == '/' || c == '\\') ? PATH_SEPARATOR : c;
+  }
+  return (String8){ .size = input.size, .str = data };
+}
+
+internal String8 path_get_file_name(String8 path) {
+  u64 last_sep = 0;
+  for (u64 i = 0; i < path.size; i++) {
+    if (path.str[i] == '\\' || path.str[i] == '/') {
+      last_sep = i + 1;
+    }
+  }
+  return (String8){
+    .str = path.str + last_sep,
+    .size = path.size - last_sep
+  };
+}
+
+internal String8 path_get_file_name_no_ext(String8 path) {
+  String8 file = path_get_file_name(path);
+
+  u64 dot = file.size;
+  for (u64 i = 0; i < file.size; i++) {
+    if (file.str[i] == '.') {
+      dot = i;
+      break;
+    }
+  }
+
+  return (String8){
+    .str = file.str,
+    .size = dot
+  };
+}
+
+internal String8 path_join(Arena* arena, String8 a, String8 b) {
+  b32 a_ends_with_sep   = (a.size > 0 && (a.str[a.size - 1] == '/' || a.str[a.size - 1] == '\\'));
+  b32 b_starts_with_sep = (b.size > 0 && (b.str[0] == '/' || b.str[0] == '\\'));
+
+  u64 total_size = a.size + b.size + 1; // +1 in case we need to insert a separator
+  if (a_ends_with_sep && b_starts_with_sep) {
+    total_size -= 1; // we’ll skip one of the slashes
+  }
+
+  char8* data = ArenaPush(arena, char8, total_size);
+  u64 pos = 0;
+
+  // Copy 'a'
+  MemoryCopy(data + pos, a.str, a.size);
+  pos += a.size;
+
+  // Handle slash insertion/removal
+  if (!a_ends_with_sep && !b_starts_with_sep && a.size > 0 && b.size > 0) {
+    data[pos++] = PATH_SEPARATOR;
+  } else if (a_ends_with_sep && b_starts_with_sep) {
+    b.str += 1;
+    b.size -= 1;
+  }
+
+  // Copy 'b'
+  MemoryCopy(data + pos, b.str, b.size);
+  pos += b.size;
+
+  return (String8){ .size = pos, .str = data };
+}
+
+internal String8 path_get_current_directory_name(String8 path) {
+  String8 result = {0};
+  u64 index = 0;
+  char8 separator = PATH_SEPARATOR;
+  if (string8_find_last(path, string8_new(1, &separator), &index)) {
+    result = string8_slice(path, index+1, path.size);
+  }
+  return result;
+}
+
+internal String8 path_dirname(String8 path) {
+  u64 last_sep = 0;
+  for (u64 i = 0; i < path.size; i++) {
+    if (path.str[i] == '/' || path.str[i] == '\\') {
+      last_sep = i;
+    }
+  }
+
+  return (String8){
+    .size = last_sep,
+    .str  = path.str,
+  };
+}
+
+internal void file_list_push(Arena* arena, File_List* list, File_Data file) {
+  File_Node* node = ArenaPush(arena, File_Node, sizeof(File_Node));
+  
+  node->value = file;
+  if (!list->first && !list->last) {
+    list->first = node;
+    list->last  = node;
+  } else {
+    list->last->next = node;
+    list->last       = node;
+  }
+  list->node_count += 1;
+  list->total_size += node->value.data.size;
+}
@@ -0,0 +1,173 @@
+#ifndef FZ_OS_H
+#define FZ_OS_H
+
+// DOC(fz): Platform independent API. Implemented per platform in win32/fz_win32.c and linux/fz_linux.c,
+// functions that are plain string work live in fz_os.c.
+
+#if OS_WINDOWS
+# define PATH_SEPARATOR '\\'
+#else
+# define PATH_SEPARATOR '/'
+#endif
+
+internal void entry_point(Command_Line command_line); // DOC(fz): Application layer must implement this function as it's entry point.
+
+///////////////////////
+//~ Memory
+internal void* memory_reserve(u64 size);
+internal b32   memory_commit(void* memory, u64 size);
+internal void  memory_decommit(void* memory, u64 size);
+internal void  memory_release(void* memory, u64 size);
+internal u64   memory_get_page_size();
+
+///////////////////////
+//~ Threading
+typedef u64 thread_func(void* context); 
+
+typedef struct Thread {
+  u64 v[1];
+} Thread;
+
+// DOC(fz): Threads created here have their own Thread_Context attached, so scratch arenas are thread local.
+internal Thread thread_create(thread_func* start, void* context);
+internal void   thread_wait_for_join(Thread* other);
+internal void   thread_wait_for_join_all(Thread** threads, u32 count);
+internal void   thread_wait_for_join_any(Thread** threads, u32 count);
+internal u32    thread_get_core_count();
+internal void   thread_yield();                     /* Lets another runnable thread have the core, returns right away if none is */
+internal void   thread_sleep_milliseconds(u32 milliseconds);
+
+///////////////////////
+//~ Time
+internal u64 time_now_microseconds(); /* Monotonic, only meaningful as a difference */
+
+///////////////////////
+//~ File handling
+
+typedef enum {
+  FileFlag_None       = 0,
+  FileFlag_WhiteList  = 1 << 0,
+  FileFlag_CFiles     = 1 << 2,
+  FileFlag_HFiles     = 1 << 3,
+  FileFlag_Dirs       = 1 << 4,
+  FileFlag_DotFiles   = 1 << 5,
+  FileFlag_DotDirs    = 1 << 6,
+} FileFlags;
+
+typedef struct File_Data {
+  String8 path;
+  String8 data;
+} File_Data;
+
+// DOC(fz): A read-only view of a whole file. data points straight into the mapping, nothing is copied.
+typedef struct File_Map {
+  String8 path;
+  String8 data;
+  b32 is_readable; // False if the file couldn't be opened or mapped. An empty file is readable
+  u64 handles[2];  // OS handles, only touched by the platform layer
+} File_Map;
+
+typedef struct File_Node {
+  struct File_Node* next;
+  File_Data value;
+} File_Node;
+
+typedef struct File_List {
+  File_Node* first;
+  File_Node* last;
+  u64 node_count;
+  u64 total_size;
+} File_List;
+
+internal void      file_list_push(Arena* arena, File_List* list, File_Data file);
+
+internal b32          file_create(String8 file_path); /* Creates file. If file exists, returns true anyway. */
+internal b32          file_exists(String8 file_path); /* Returns true if file exists */
+internal u32          file_overwrite(String8 file_path, char8* data, u64 data_size);
+internal u32          file_append(String8 file_path, char8* data, u64 data_size);
+internal b32          file_wipe(String8 file_path);
+internal b32          file_rename(String8 from_path, String8 to_path); /* Replaces to_path if it exists. Atomic when both are on the same volume */
+internal u32          file_size(String8 file_path);
+internal File_Data    file_load(Arena* arena, String8 file_path);
+internal File_Map     file_map_open(String8 file_path); /* Maps file read-only. data.size is 0 if it is empty or not is_readable. Prints nothing, the caller reports */
+internal void         file_map_close(File_Map* map);
+internal b32          file_has_extension(String8 filename, String8 ext);
+internal u64          file_get_last_modified_time(String8 file_path);
+internal String8_List file_get_all_file_paths_recursively(Arena* arena, String8 path);
+
+// DOC(fz): Calls visit for every entry directly inside directory_path, except . and .., in the order the OS lists them.
+// name only lives for the call. Nothing is allocated, so visit can push into any arena, scratch included.
+typedef void directory_visit_func(String8 directory_path, String8 name, b32 is_directory, void* context);
+internal b32 directory_visit(String8 directory_path, directory_visit_func* visit, void* context); /* False if the directory can't be listed */
+
+typedef struct _File_Paths_Walk {
+  Arena* arena;         // Result paths
+  Arena* scratch;       // Directories still to visit
+  String8_List* result;
+  String8_List* queue;
+} _File_Paths_Walk;
+
+internal void _file_paths_visit(String8 directory_path, String8 name, b32 is_directory, void* context);
+
+internal b32 directory_create(String8 directory_path);
+internal b32 directory_exists(String8 directory_path);
+
+internal String8 path_new(Arena* arena, String8 path);
+internal b32     path_create_as_directory(String8 path);
+internal b32     path_is_file(String8 path);
+internal b32     path_is_directory(String8 path);
+internal String8 path_get_working_directory();
+internal String8 path_get_executable();
+internal String8 path_get_file_name(String8 path);
+internal String8 path_get_file_name_no_ext(String8 path);
+internal String8 path_join(Arena* arena, String8 a, String8 b);
+internal String8 path_get_current_directory_name(String8 path);
+internal String8 path_dirname(String8 path);
+
+///////////////////////
+//~ File watching
+// DOC(fz): Reports what was created, written, moved or deleted anywhere under a directory. Linux puts an inotify watch
+// on every directory of the tree and follows directories as they appear, Windows watches the tree with one
+// ReadDirectoryChangesW. Reading never blocks, changes queue up in the OS until the next read.
+typedef struct File_Watch {
+  String8 path;
+  Arena* arena;   // Platform bookkeeping, freed by file_watch_close
+  u64 handles[4]; // OS handles, only touched by the platform layer
+} File_Watch;
+
+internal File_Watch   file_watch_open(String8 directory_path);          /* arena is NULL if the directory can't be watched */
+internal String8_List file_watch_read(Arena* arena, File_Watch* watch); /* Paths changed since the last read. A directory path means anything under it may have changed */
+internal void         file_watch_close(File_Watch* watch);
+
+///////////////////////
+//~ Local sockets
+// DOC(fz): Byte streams between processes on the same machine, found by name. A Unix domain socket in the abstract
+// namespace on Linux, so there is no file to clean up, and a named pipe on Windows.
+typedef struct Local_Socket {
+  u64 handles[4]; // OS handles, only touched by the platform layer. All 0 when invalid
+} Local_Socket;
+
+internal Local_Socket local_socket_listen(String8 name);                                   /* Invalid if name is taken */
+internal Local_Socket local_socket_accept(Local_Socket* server, u32 timeout_milliseconds); /* Invalid on timeout */
+internal Local_Socket local_socket_connect(String8 name);                                  /* Invalid if nothing listens on name */
+internal b32          local_socket_is_valid(Local_Socket* socket);
+internal String8      local_socket_read(Arena* arena, Local_Socket* socket, u64 max_size); /* Blocks for at least one byte. Empty once the peer closed */
+internal b32          local_socket_write(Local_Socket* socket, String8 data);              /* Blocks until all of data is written */
+internal void         local_socket_close(Local_Socket* socket);
+
+///////////////////////
+//~ Logging 
+internal void println_string(String8 string); // TODO(fz): This should be abstracted into a more generic win32_print that then String can use to implement it's own print_string
+
+///////////////////////
+//~ Error
+// TODO(Fz): I'm not sure if I like this macro. Feels constrained and unecessary
+String8 ErrorLogFile = { 0 };
+internal void set_error_log_file(String8 file_path) {
+  ErrorLogFile = file_path;
+}
+
+#define ERROR_MESSAGE_AND_EXIT(fmt, ...) _error_message_and_exit(__FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+internal void _error_message_and_exit(const char8 *file, int line, const char8 *func, const char8 *fmt, ...);
+
+#endif // FZ_OS_H
@@ -47,6 +47,14 @@ internal b32 string8_equal(String8 a, String8 b) {
   return true;
 }
 
+internal s32 string8_compare(String8 a, String8 b) {
+  s32 result = memcmp(a.str, b.str, Min(a.size, b.size));
+  if (result == 0) {
+    result = (a.size > b.size) - (a.size < b.size);
+  }
+  return result;
+}
+
 internal String8 string8_slice(String8 str, u64 start, u64 end) {
   if (start > str.size) start = str.size;
   if (end > str.size)   end   = str.size;
@@ -63,6 +71,14 @@ internal String8 string8_copy(Arena* arena, String8 src) {
   };
 }
 
+internal String8 string8_trim(String8 str) {
+  u64 start = 0;
+  u64 end   = str.size;
+  while (start < end && char8_is_space(str.str[start]))   start += 1;
+  while (end > start && char8_is_space(str.str[end - 1])) end   -= 1;
+  return string8_slice(str, start, end);
+}
+
 internal b32 string8_find_last(String8 str, String8 substring, u64* index) {
   if (substring.size > str.size) return 0;
   b32 result = false;
@@ -223,6 +239,7 @@ internal String8 string8_from_cstring(char8* cstring) {
   return result;
 }
 
+#if OS_WINDOWS
 internal String16 string16_from_string8(Arena *arena, String8 str8) {
   String16 result = {0};
   s32 str16_length = MultiByteToWideChar(CP_UTF8, 0, str8.str, (s32)str8.size, NULL, 0);
@@ -251,6 +268,7 @@ internal wchar_t* wcstr_from_string16(Arena *arena, String16 str16) {
   wcstr[str16.size] = L'\0';
   return wcstr;
 }
+#endif
 
 //~ Char Functions
 internal b32 char8_is_alpha(char8 c) {
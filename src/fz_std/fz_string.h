@@ -31,6 +31,7 @@ internal b32     string8_contains(String8 str, String8 substring);
 internal b32     string8_find_first(String8 str, String8 substring, u64* index);
 internal b32     string8_find_last(String8 str, String8 substring, u64* index); 
 internal b32     string8_equal(String8 a, String8 b);
+internal s32     string8_compare(String8 a, String8 b); /* Byte order, a prefix first. < 0, 0 or > 0 like memcmp */
 internal void    string8_printf(String8 str);
 
 internal String8_List string8_split(Arena* arena, String8 str, String8 split_character);
@@ -53,9 +54,11 @@ typedef struct String16 {
 } String16;
 #define Str16(s) (String16{sizeof(s)-1, (char16*)(s)};
 
+#if OS_WINDOWS
 internal String8  string8_from_string16(Arena* arena, String16 str16);
 internal String16 string16_from_string8(Arena *arena, String8 str8);
 internal wchar_t* wcstr_from_string16(Arena *arena, String16 str16); // TODO(fz): This is a windows only function.
+#endif
 
 //~ Char Functions
 internal b32   char8_is_alpha(char8 c);
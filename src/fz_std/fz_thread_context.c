@@ -9,7 +9,7 @@ internal void thread_context_init_and_attach(Thread_Context* thread_context) {
 
 internal void thread_context_free() {
   for(u64 i = 0; i < ArrayCount(ThreadContextThreadLocal->arenas); i += 1) {
-    arena_release(ThreadContextThreadLocal->arenas[i]);
+    arena_free(ThreadContextThreadLocal->arenas[i]);
   }
 }
 
@@ -0,0 +1,178 @@
+///////////////
+// Thread pool
+internal Thread_Pool* thread_pool_init(Arena* arena, u32 worker_count) {
+  if (worker_count == 0) {
+    worker_count = thread_get_core_count();
+  }
+  worker_count = Max(worker_count, 1);
+
+  Thread_Pool* pool  = ArenaPush(arena, Thread_Pool, 1);
+  pool->arena        = arena;
+  pool->workers      = ArenaPush(arena, Thread_Pool_Worker, worker_count);
+  pool->worker_count = worker_count;
+
+  for (u32 i = 0; i < worker_count; i += 1) {
+    Thread_Pool_Worker* worker = &pool->workers[i];
+    worker->pool  = pool;
+    worker->arena = arena_init();
+    worker->index = i;
+  }
+  return pool;
+}
+
+internal void thread_pool_push(Thread_Pool* pool, thread_job_func* func, void* context) {
+  Thread_Job job = { func, context };
+  Thread_Pool_Worker* worker = &pool->workers[pool->next_queue];
+  thread_job_queue_push(pool->arena, &worker->queue, job);
+  pool->next_queue = (pool->next_queue + 1) % pool->worker_count;
+  pool->pending   += 1;
+}
+
+internal void thread_pool_run(Thread_Pool* pool) {
+  for (u32 i = 1; i < pool->worker_count; i += 1) {
+    pool->workers[i].thread = thread_create(thread_pool_worker_entry, &pool->workers[i]);
+  }
+
+  thread_pool_worker_loop(&pool->workers[0]);
+
+  for (u32 i = 1; i < pool->worker_count; i += 1) {
+    thread_wait_for_join(&pool->workers[i].thread);
+  }
+
+  // NOTE(fz): Every queue is drained at this point, rewind them so the pool can be reused.
+  for (u32 i = 0; i < pool->worker_count; i += 1) {
+    pool->workers[i].queue.top    = 0;
+    pool->workers[i].queue.bottom = 0;
+  }
+  pool->next_queue = 0;
+}
+
+internal void thread_pool_release(Thread_Pool* pool) {
+  for (u32 i = 0; i < pool->worker_count; i += 1) {
+    arena_free(pool->workers[i].arena);
+  }
+  MemoryZeroStruct(pool);
+}
+
+internal void thread_pool_push_from_job(thread_job_func* func, void* context) {
+  Thread_Pool_Worker* worker = ThreadPoolWorkerThreadLocal;
+  Assert(worker != NULL);
+  Thread_Job job = { func, context };
+
+  // NOTE(fz): Counted before it is visible, the pool can't look finished while this job still has work to hand out.
+  atomic_increment_u64(&worker->pool->pending);
+  // Thieves read the queue while it runs, and growing moves it. The worker arena is only ever touched by this thread.
+  thread_job_queue_lock(&worker->queue);
+  thread_job_queue_push(worker->arena, &worker->queue, job);
+  thread_job_queue_unlock(&worker->queue);
+}
+
+internal u32 thread_pool_worker_index() {
+  Assert(ThreadPoolWorkerThreadLocal != NULL);
+  return ThreadPoolWorkerThreadLocal->index;
+}
+
+internal u64 thread_pool_worker_entry(void* context) {
+  thread_pool_worker_loop((Thread_Pool_Worker*)context);
+  return 0;
+}
+
+internal void thread_pool_worker_loop(Thread_Pool_Worker* worker) {
+  Thread_Pool* pool = worker->pool;
+  Thread_Job job;
+  u32 idle_rounds = 0;
+  ThreadPoolWorkerThreadLocal = worker;
+
+  for (;;) {
+    if (thread_job_queue_pop(&worker->queue, &job)) {
+      job.func(worker->arena, job.context);
+      atomic_decrement_u64(&pool->pending);
+      worker->jobs_run += 1;
+      idle_rounds = 0;
+      continue;
+    }
+
+    b32 stole = false;
+    for (u32 i = 1; i < pool->worker_count && !stole; i += 1) {
+      Thread_Pool_Worker* victim = &pool->workers[(worker->index + i) % pool->worker_count];
+      stole = thread_job_queue_steal(&victim->queue, &job);
+    }
+    if (!stole) {
+      // Every queue is empty, but a job still running may push more
+      if (atomic_load_u64(&pool->pending) == 0) {
+        break;
+      }
+      // NOTE(fz): Spins while a job that just started may still push more, then gives the core away, so one long last
+      // job doesn't keep every idle worker busy taking queue locks until it finishes.
+      if (idle_rounds < THREAD_POOL_SPIN_ROUNDS) {
+        cpu_pause();
+      } else if (idle_rounds < THREAD_POOL_SPIN_ROUNDS + THREAD_POOL_YIELD_ROUNDS) {
+        thread_yield();
+      } else {
+        thread_sleep_milliseconds(1);
+      }
+      idle_rounds += 1;
+      continue;
+    }
+    idle_rounds = 0;
+
+    job.func(worker->arena, job.context);
+    atomic_decrement_u64(&pool->pending);
+    worker->jobs_run    += 1;
+    worker->jobs_stolen += 1;
+  }
+
+  ThreadPoolWorkerThreadLocal = 0;
+}
+
+///////////////
+// Job queue
+internal void thread_job_queue_push(Arena* arena, Thread_Job_Queue* queue, Thread_Job job) {
+  if (queue->bottom == queue->capacity) {
+    u32 new_capacity = (queue->capacity == 0) ? THREAD_POOL_QUEUE_CAPACITY : queue->capacity * 2;
+    Thread_Job* new_jobs = ArenaPushNoZero(arena, Thread_Job, new_capacity);
+    if (queue->bottom > 0) {
+      MemoryCopy(new_jobs, queue->jobs, queue->bottom * sizeof(Thread_Job));
+    }
+    queue->jobs     = new_jobs;
+    queue->capacity = new_capacity;
+  }
+  queue->jobs[queue->bottom] = job;
+  queue->bottom += 1;
+}
+
+internal b32 thread_job_queue_pop(Thread_Job_Queue* queue, Thread_Job* job) {
+  b32 result = false;
+  thread_job_queue_lock(queue);
+  if (queue->top < queue->bottom) {
+    queue->bottom -= 1;
+    *job   = queue->jobs[queue->bottom];
+    result = true;
+  }
+  thread_job_queue_unlock(queue);
+  return result;
+}
+
+internal b32 thread_job_queue_steal(Thread_Job_Queue* queue, Thread_Job* job) {
+  b32 result = false;
+  thread_job_queue_lock(queue);
+  if (queue->top < queue->bottom) {
+    *job   = queue->jobs[queue->top];
+    queue->top += 1;
+    result = true;
+  }
+  thread_job_queue_unlock(queue);
+  return result;
+}
+
+internal void thread_job_queue_lock(Thread_Job_Queue* queue) {
+  while (atomic_compare_exchange_u32(&queue->lock, 0, 1) != 0) {
+    while (atomic_load_u32(&queue->lock) != 0) {
+      cpu_pause();
+    }
+  }
+}
+
+internal void thread_job_queue_unlock(Thread_Job_Queue* queue) {
+  atomic_store_u32(&queue->lock, 0);
+}
@@ -0,0 +1,70 @@
+#ifndef FZ_THREAD_POOL_H
+#define FZ_THREAD_POOL_H
+
+// DOC(fz): Work stealing thread pool.
+// Jobs are pushed from the main thread before thread_pool_run, spread round robin over the worker queues.
+// Each worker pops from the bottom of its own queue and, once it runs dry, steals from the top of the others.
+// A running job can push more jobs onto the queue of the worker running it, so a directory walk can push a job per
+// subdirectory. A worker that finds every queue empty is done once no job is pending anywhere, not before.
+// Worker 0 is the calling thread, every other worker is a thread from thread_create with its own Thread_Context,
+// so scratch arenas stay thread local. Jobs allocate anything that must outlive them in the worker arena,
+// which lives until thread_pool_release.
+
+struct Thread_Pool;
+
+typedef void thread_job_func(Arena* arena, void* context);
+
+typedef struct Thread_Job {
+  thread_job_func* func;
+  void* context;
+} Thread_Job;
+
+typedef struct Thread_Job_Queue {
+  Thread_Job* jobs;
+  u32 capacity;
+  u32 top;    // Thieves take from here
+  u32 bottom; // Owner pushes and pops here
+  u32 lock;   // NOTE(fz): Jobs are coarse (whole files), a spin lock per queue is cheaper than it sounds.
+} Thread_Job_Queue;
+
+typedef struct Thread_Pool_Worker {
+  struct Thread_Pool* pool;
+  Arena* arena;
+  Thread_Job_Queue queue;
+  Thread thread;
+  u32 index;
+  u64 jobs_run;
+  u64 jobs_stolen;
+} Thread_Pool_Worker;
+
+typedef struct Thread_Pool {
+  Arena* arena;
+  Thread_Pool_Worker* workers;
+  u32 worker_count;
+  u32 next_queue;
+  u64 pending; // Jobs pushed and not finished yet
+} Thread_Pool;
+
+#define THREAD_POOL_QUEUE_CAPACITY 64
+#define THREAD_POOL_SPIN_ROUNDS    64  // Rounds over every queue an idle worker spins through before it yields
+#define THREAD_POOL_YIELD_ROUNDS   256 // Rounds it then yields through before it sleeps a millisecond between rounds
+
+C_LINKAGE thread_static Thread_Pool_Worker* ThreadPoolWorkerThreadLocal = 0; // The worker running on this thread, during thread_pool_run
+
+internal Thread_Pool* thread_pool_init(Arena* arena, u32 worker_count); /* worker_count of 0 uses one worker per core */
+internal void         thread_pool_push(Thread_Pool* pool, thread_job_func* func, void* context);
+internal void         thread_pool_run(Thread_Pool* pool); /* Blocks until every pushed job ran */
+internal void         thread_pool_release(Thread_Pool* pool);
+internal void         thread_pool_push_from_job(thread_job_func* func, void* context); /* Only from a running job, onto the queue of the worker running it */
+internal u32          thread_pool_worker_index();                                     /* Of the worker running the calling job */
+
+internal u64  thread_pool_worker_entry(void* context);
+internal void thread_pool_worker_loop(Thread_Pool_Worker* worker);
+
+internal void thread_job_queue_push(Arena* arena, Thread_Job_Queue* queue, Thread_Job job);
+internal b32  thread_job_queue_pop(Thread_Job_Queue* queue, Thread_Job* job);
+internal b32  thread_job_queue_steal(Thread_Job_Queue* queue, Thread_Job* job);
+internal void thread_job_queue_lock(Thread_Job_Queue* queue);
+internal void thread_job_queue_unlock(Thread_Job_Queue* queue);
+
+#endif // FZ_THREAD_POOL_H
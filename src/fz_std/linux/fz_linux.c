@@ -0,0 +1,636 @@
+//~ Memory
+internal void* memory_reserve(u64 size) {
+  void* result = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (result == MAP_FAILED) {
+    result = NULL;
+  }
+  return result;
+}
+
+internal b32 memory_commit(void* memory, u64 size) {
+  b32 result = (mprotect(memory, size, PROT_READ | PROT_WRITE) == 0);
+  return result;
+}
+
+internal void memory_decommit(void* memory, u64 size) {
+  madvise(memory, size, MADV_DONTNEED);
+  mprotect(memory, size, PROT_NONE);
+}
+
+internal void memory_release(void* memory, u64 size) {
+  munmap(memory, size);
+}
+
+internal u64 memory_get_page_size() {
+  return (u64)sysconf(_SC_PAGESIZE);
+}
+
+//~ Threading
+internal void* _linux_thread_entry(void* parameter) {
+  _Linux_Thread_Start start = *(_Linux_Thread_Start*)parameter;
+  free(parameter);
+
+  Thread_Context thread_context;
+  thread_context_init_and_attach(&thread_context);
+  u64 result = start.start(start.context);
+  thread_context_free();
+  return (void*)result;
+}
+
+internal Thread thread_create(thread_func* start, void* context) {
+  Thread result = {0};
+  _Linux_Thread_Start* parameter = malloc(sizeof(_Linux_Thread_Start));
+  parameter->start   = start;
+  parameter->context = context;
+
+  pthread_t handle;
+  s32 error = pthread_create(&handle, NULL, _linux_thread_entry, parameter);
+  if (error != 0) {
+    free(parameter);
+    ERROR_MESSAGE_AND_EXIT("pthread_create failed with error: %d", error);
+  }
+  result.v[0] = (u64)handle;
+  return result;
+}
+
+internal void thread_wait_for_join(Thread* other) {
+  pthread_join((pthread_t)other->v[0], NULL);
+  other->v[0] = 0;
+}
+
+internal void thread_wait_for_join_all(Thread** threads, u32 count) {
+  for (u32 i = 0; i < count; i += 1) {
+    thread_wait_for_join(threads[i]);
+  }
+}
+
+internal void thread_wait_for_join_any(Thread** threads, u32 count) {
+  // NOTE(fz): pthreads has no join-any, poll with the non blocking join instead.
+  for (;;) {
+    for (u32 i = 0; i < count; i += 1) {
+      if (threads[i]->v[0] && pthread_tryjoin_np((pthread_t)threads[i]->v[0], NULL) == 0) {
+        threads[i]->v[0] = 0;
+        return;
+      }
+    }
+    sched_yield();
+  }
+}
+
+internal u32 thread_get_core_count() {
+  s64 count = sysconf(_SC_NPROCESSORS_ONLN);
+  return (count > 0) ? (u32)count : 1;
+}
+
+internal void thread_yield() {
+  sched_yield();
+}
+
+internal void thread_sleep_milliseconds(u32 milliseconds) {
+  struct timespec duration = { .tv_sec = milliseconds / 1000, .tv_nsec = (s64)(milliseconds % 1000) * 1000000 };
+  nanosleep(&duration, NULL);
+}
+
+//~ Time
+internal u64 time_now_microseconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (u64)now.tv_sec * Million(1) + (u64)now.tv_nsec / 1000;
+}
+
+//~ File handling
+internal char8* _linux_cstring_from_path(Arena* arena, String8 path) {
+  char8* result = cstring_from_string8(arena, path);
+  return result;
+}
+
+internal b32 file_create(String8 file_path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  b32 result = false;
+
+  char8* cpath = _linux_cstring_from_path(scratch.arena, file_path);
+  s32 fd = open((char*)cpath, O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (fd >= 0) {
+    close(fd);
+    result = true;
+  } else if (errno == EEXIST) {
+    result = true;
+  } else {
+    printf("Error creating file %s with error: %d\n", cpath, errno);
+  }
+
+  scratch_end(&scratch);
+  return result;
+}
+
+internal u64 file_get_last_modified_time(String8 file_path) {
+  // NOTE(fz): 100ns ticks, same unit as the Win32 FILETIME. The epoch differs, only compare values from the same platform.
+  u64 result = 0;
+  Arena_Temp scratch = scratch_begin(0, 0);
+  struct stat st;
+  if (stat((char*)_linux_cstring_from_path(scratch.arena, file_path), &st) == 0) {
+    result = (u64)st.st_mtim.tv_sec * 10000000ull + (u64)st.st_mtim.tv_nsec / 100;
+  }
+  scratch_end(&scratch);
+  return result;
+}
+
+internal b32 directory_visit(String8 directory_path, directory_visit_func* visit, void* context) {
+  // NOTE(fz): Stack buffers only, visit may be pushing into this thread's scratch arena.
+  char path[PATH_MAX];
+  if (directory_path.size >= sizeof(path)) {
+    return false;
+  }
+  MemoryCopy(path, directory_path.str, directory_path.size);
+  path[directory_path.size] = 0;
+
+  s32 dir_fd = openat(AT_FDCWD, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir_fd < 0) {
+    return false;
+  }
+
+  u8 buffer[LINUX_DIRENT_BUFFER_SIZE] __attribute__((aligned(8)));
+  for (;;) {
+    s64 bytes = syscall(SYS_getdents64, dir_fd, buffer, sizeof(buffer));
+    if (bytes <= 0) break;
+
+    for (s64 offset = 0; offset < bytes;) {
+      _Linux_Dirent64* entry = (_Linux_Dirent64*)(buffer + offset);
+      offset += entry->d_reclen;
+
+      String8 name = string8_from_cstring((char8*)entry->d_name);
+      if (string8_equal(name, Str8(".")) || string8_equal(name, Str8(".."))) {
+        continue;
+      }
+
+      u8 type = entry->d_type;
+      if (type == LINUX_DT_UNKNOWN) {
+        struct stat st;
+        if (fstatat(dir_fd, entry->d_name, &st, 0) == 0) {
+          type = S_ISDIR(st.st_mode) ? LINUX_DT_DIR : LINUX_DT_REG;
+        }
+      }
+      visit(directory_path, name, type == LINUX_DT_DIR, context);
+    }
+  }
+
+  close(dir_fd);
+  return true;
+}
+
+internal b32 path_create_as_directory(String8 path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  b32 result = (mkdir((char*)_linux_cstring_from_path(scratch.arena, path), 0755) == 0 || errno == EEXIST);
+  scratch_end(&scratch);
+  return result;
+}
+
+internal b32 path_is_file(String8 path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  struct stat st;
+  b32 result = (stat((char*)_linux_cstring_from_path(scratch.arena, path), &st) == 0 && S_ISREG(st.st_mode));
+  scratch_end(&scratch);
+  return result;
+}
+
+internal b32 path_is_directory(String8 path) {
+  if (path.size == 0 || path.str == NULL) {
+    return false;
+  }
+
+  Arena_Temp scratch = scratch_begin(0, 0);
+  struct stat st;
+  b32 result = (stat((char*)_linux_cstring_from_path(scratch.arena, path), &st) == 0 && S_ISDIR(st.st_mode));
+  scratch_end(&scratch);
+  return result;
+}
+
+internal String8 path_get_executable() {
+  local_persist char8 buffer[PATH_MAX];
+  s64 len = readlink("/proc/self/exe", (char*)buffer, sizeof(buffer) - 1);
+  if (len < 0) {
+    return (String8){0};
+  }
+  buffer[len] = 0;
+  return (String8){ .size = (u64)len, .str = buffer };
+}
+
+internal String8 path_get_working_directory(void) {
+  local_persist char8 buffer[PATH_MAX];
+  if (getcwd((char*)buffer, sizeof(buffer)) == NULL) {
+    return (String8){0};
+  }
+  return string8_from_cstring(buffer);
+}
+
+internal b32 file_exists(String8 file_path) {
+  return path_is_file(file_path);
+}
+
+internal b32 directory_create(String8 directory_path) {
+  return path_create_as_directory(directory_path);
+}
+
+internal b32 directory_exists(String8 directory_path) {
+  return path_is_directory(directory_path);
+}
+
+internal u32 _linux_file_write(String8 file_path, s32 flags, char8* data, u64 data_size) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  char8* cpath = _linux_cstring_from_path(scratch.arena, file_path);
+
+  s32 fd = open((char*)cpath, O_WRONLY | O_CREAT | flags, 0644);
+  if (fd < 0) {
+    printf("open failed: error code %d for file %s\n", errno, cpath);
+    scratch_end(&scratch);
+    return 0;
+  }
+
+  u64 written = 0;
+  while (written < data_size) {
+    s64 result = write(fd, data + written, data_size - written);
+    if (result <= 0) {
+      printf("write failed: error code %d\n", errno);
+      break;
+    }
+    written += (u64)result;
+  }
+
+  close(fd);
+  scratch_end(&scratch);
+  return (u32)written;
+}
+
+internal u32 file_overwrite(String8 file_path, char8* data, u64 data_size) {
+  return _linux_file_write(file_path, O_TRUNC, data, data_size);
+}
+
+internal u32 file_append(String8 file_path, char8* data, u64 data_size) {
+  return _linux_file_write(file_path, O_APPEND, data, data_size);
+}
+
+internal b32 file_wipe(String8 file_path) {
+  if (!file_exists(file_path)) {
+    return true;
+  }
+
+  Arena_Temp scratch = scratch_begin(0, 0);
+  b32 result = (truncate((char*)_linux_cstring_from_path(scratch.arena, file_path), 0) == 0);
+  scratch_end(&scratch);
+  return result;
+}
+
+internal b32 file_rename(String8 from_path, String8 to_path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  char8* from = _linux_cstring_from_path(scratch.arena, from_path);
+  char8* to   = _linux_cstring_from_path(scratch.arena, to_path);
+  b32 result  = (rename((char*)from, (char*)to) == 0);
+  scratch_end(&scratch);
+  return result;
+}
+
+internal u32 file_size(String8 file_path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  u32 result = 0;
+  struct stat st;
+  if (stat((char*)_linux_cstring_from_path(scratch.arena, file_path), &st) == 0) {
+    result = (u32)st.st_size;
+  } else {
+    printf("Error: file_size failed because file %.*s doesn't exist\n", (s32)file_path.size, file_path.str);
+  }
+  scratch_end(&scratch);
+  return result;
+}
+
+internal File_Data file_load(Arena* arena, String8 file_path) {
+  File_Data result = { 0 };
+  Arena_Temp scratch = scratch_begin(&arena, 1);
+
+  s32 fd = open((char*)_linux_cstring_from_path(scratch.arena, file_path), O_RDONLY | O_CLOEXEC);
+  scratch_end(&scratch);
+  if (fd < 0) {
+    printf("Error: file_load failed because file %.*s can't be opened\n", (s32)file_path.size, file_path.str);
+    return result;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return result;
+  }
+
+  u64 size    = (u64)st.st_size;
+  char8* data = ArenaPushNoZero(arena, char8, size);
+  u64 total   = 0;
+  while (total < size) {
+    s64 read_size = read(fd, data + total, size - total);
+    if (read_size <= 0) break;
+    total += (u64)read_size;
+  }
+  close(fd);
+
+  result.path      = file_path;
+  result.data.str  = data;
+  result.data.size = total;
+  return result;
+}
+
+internal File_Map file_map_open(String8 file_path) {
+  File_Map result = { 0 };
+  result.path = file_path;
+
+  Arena_Temp scratch = scratch_begin(0, 0);
+  s32 fd = open((char*)_linux_cstring_from_path(scratch.arena, file_path), O_RDONLY | O_CLOEXEC);
+  scratch_end(&scratch);
+  if (fd < 0) {
+    return result;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return result;
+  }
+  if (st.st_size == 0) {
+    // NOTE(fz): Zero sized mappings are invalid. They are still a valid, empty, File_Map.
+    close(fd);
+    result.is_readable = true;
+    return result;
+  }
+
+  void* view = mmap(0, (u64)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps the file alive
+  if (view == MAP_FAILED) {
+    return result;
+  }
+
+  result.data.str    = (char8*)view;
+  result.data.size   = (u64)st.st_size;
+  result.is_readable = true;
+  return result;
+}
+
+internal void file_map_close(File_Map* map) {
+  if (map->data.str) {
+    munmap(map->data.str, map->data.size);
+  }
+  MemoryZeroStruct(map);
+}
+
+//~ File watching
+internal File_Watch file_watch_open(String8 directory_path) {
+  File_Watch result = { 0 };
+  s32 fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) {
+    printf("Error: %d in file_watch_open.\n", errno);
+    return result;
+  }
+
+  result.arena      = arena_init();
+  result.path       = string8_copy(result.arena, directory_path);
+  result.handles[0] = (u64)fd;
+  _linux_watch_add_tree(&result, result.path);
+  return result;
+}
+
+internal String8_List file_watch_read(Arena* arena, File_Watch* watch) {
+  String8_List result = { 0 };
+  if (watch->arena == NULL) {
+    return result;
+  }
+
+  s32 fd = (s32)watch->handles[0];
+  u8 buffer[LINUX_WATCH_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+  for (;;) {
+    s64 bytes = read(fd, buffer, sizeof(buffer));
+    if (bytes <= 0) break; // EAGAIN, the queue is drained
+
+    for (s64 offset = 0; offset < bytes;) {
+      struct inotify_event* event = (struct inotify_event*)(buffer + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+
+      if (HasFlags(event->mask, IN_Q_OVERFLOW)) {
+        // Events were dropped, anything under the root may have changed
+        string8_list_push(arena, &result, watch->path);
+        continue;
+      }
+
+      _Linux_Watch_Directory* previous  = NULL;
+      _Linux_Watch_Directory* directory = (_Linux_Watch_Directory*)watch->handles[1];
+      while (directory != NULL && directory->descriptor != event->wd) {
+        previous  = directory;
+        directory = directory->next;
+      }
+      if (directory == NULL) continue;
+      if (HasFlags(event->mask, IN_IGNORED)) {
+        // The directory is gone and the kernel dropped its watch
+        if (previous != NULL) previous->next = directory->next;
+        else                  watch->handles[1] = (u64)directory->next;
+        continue;
+      }
+      if (event->len == 0) continue;
+
+      String8 path = path_join(arena, directory->path, string8_from_cstring((char8*)event->name));
+      if (HasFlags(event->mask, IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+        // NOTE(fz): Files can land in a new directory before its watch exists. Reporting the directory tells the reader to look inside.
+        _linux_watch_add_tree(watch, path);
+      }
+      string8_list_push(arena, &result, path);
+    }
+  }
+
+  return result;
+}
+
+internal void file_watch_close(File_Watch* watch) {
+  if (watch->arena != NULL) {
+    close((s32)watch->handles[0]);
+    arena_free(watch->arena);
+  }
+  MemoryZeroStruct(watch);
+}
+
+internal void _linux_watch_add_tree(File_Watch* watch, String8 directory_path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  String8_List queue = {0};
+  string8_list_push(scratch.arena, &queue, directory_path);
+  _File_Paths_Walk walk = { scratch.arena, scratch.arena, &queue, &queue }; // Only directories go on the queue
+
+  while (queue.node_count > 0) {
+    String8 current_dir = string8_list_pop(&queue);
+    _linux_watch_add(watch, current_dir);
+    directory_visit(current_dir, _linux_watch_visit, &walk);
+  }
+
+  scratch_end(&scratch);
+}
+
+internal void _linux_watch_visit(String8 directory_path, String8 name, b32 is_directory, void* context) {
+  if (is_directory) {
+    _file_paths_visit(directory_path, name, is_directory, context);
+  }
+}
+
+internal void _linux_watch_add(File_Watch* watch, String8 directory_path) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  s32 descriptor = inotify_add_watch((s32)watch->handles[0], (char*)_linux_cstring_from_path(scratch.arena, directory_path), LINUX_WATCH_MASK);
+  scratch_end(&scratch);
+  if (descriptor < 0) {
+    return;
+  }
+
+  // The same directory gives back the same descriptor, a directory moved within the tree only changes its path
+  _Linux_Watch_Directory* directory = (_Linux_Watch_Directory*)watch->handles[1];
+  while (directory != NULL && directory->descriptor != descriptor) {
+    directory = directory->next;
+  }
+  if (directory == NULL) {
+    directory = ArenaPush(watch->arena, _Linux_Watch_Directory, 1);
+    directory->descriptor = descriptor;
+    directory->next       = (_Linux_Watch_Directory*)watch->handles[1];
+    watch->handles[1]     = (u64)directory;
+  }
+  directory->path = string8_copy(watch->arena, directory_path);
+}
+
+//~ Local sockets
+internal socklen_t _linux_socket_address(struct sockaddr_un* address, String8 name) {
+  MemoryZeroStruct(address);
+  address->sun_family = AF_UNIX;
+  // NOTE(fz): A leading zero byte puts the name in the abstract namespace. It has no file and goes away with the socket.
+  u64 size = Min(name.size, sizeof(address->sun_path) - 1);
+  MemoryCopy(address->sun_path + 1, name.str, size);
+  return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + size);
+}
+
+internal Local_Socket local_socket_listen(String8 name) {
+  Local_Socket result = { 0 };
+  s32 fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    printf("Error: %d in local_socket_listen.\n", errno);
+    return result;
+  }
+
+  struct sockaddr_un address;
+  socklen_t address_size = _linux_socket_address(&address, name);
+  if (bind(fd, (struct sockaddr*)&address, address_size) != 0 || listen(fd, SOMAXCONN) != 0) {
+    close(fd);
+    return result;
+  }
+
+  result.handles[0] = (u64)fd + 1; // NOTE(fz): Stored off by one, 0 is the invalid socket
+  return result;
+}
+
+internal Local_Socket local_socket_accept(Local_Socket* server, u32 timeout_milliseconds) {
+  Local_Socket result = { 0 };
+  if (!local_socket_is_valid(server)) {
+    return result;
+  }
+
+  struct pollfd listener = { .fd = (s32)(server->handles[0] - 1), .events = POLLIN };
+  if (poll(&listener, 1, (s32)timeout_milliseconds) > 0) {
+    s32 fd = accept4(listener.fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd >= 0) {
+      result.handles[0] = (u64)fd + 1;
+    }
+  }
+  return result;
+}
+
+internal Local_Socket local_socket_connect(String8 name) {
+  Local_Socket result = { 0 };
+  s32 fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return result;
+  }
+
+  struct sockaddr_un address;
+  socklen_t address_size = _linux_socket_address(&address, name);
+  if (connect(fd, (struct sockaddr*)&address, address_size) != 0) {
+    close(fd);
+    return result;
+  }
+
+  result.handles[0] = (u64)fd + 1;
+  return result;
+}
+
+internal b32 local_socket_is_valid(Local_Socket* socket) {
+  return socket->handles[0] != 0;
+}
+
+internal String8 local_socket_read(Arena* arena, Local_Socket* socket, u64 max_size) {
+  String8 result = { 0 };
+  if (!local_socket_is_valid(socket)) {
+    return result;
+  }
+
+  result.str = ArenaPushNoZero(arena, char8, max_size);
+  for (;;) {
+    s64 bytes = read((s32)(socket->handles[0] - 1), result.str, max_size);
+    if (bytes < 0 && errno == EINTR) continue;
+    result.size = (bytes > 0) ? (u64)bytes : 0;
+    break;
+  }
+  arena_pop(arena, max_size - result.size);
+  return result;
+}
+
+internal b32 local_socket_write(Local_Socket* socket, String8 data) {
+  if (!local_socket_is_valid(socket)) {
+    return false;
+  }
+
+  u64 total = 0;
+  while (total < data.size) {
+    // NOTE(fz): A peer that went away must not take the process down with SIGPIPE.
+    s64 bytes = send((s32)(socket->handles[0] - 1), data.str + total, data.size - total, MSG_NOSIGNAL);
+    if (bytes < 0 && errno == EINTR) continue;
+    if (bytes <= 0) return false;
+    total += (u64)bytes;
+  }
+  return true;
+}
+
+internal void local_socket_close(Local_Socket* socket) {
+  if (local_socket_is_valid(socket)) {
+    close((s32)(socket->handles[0] - 1));
+  }
+  MemoryZeroStruct(socket);
+}
+
+//~ Logging
+internal void println_string(String8 string) {
+  write(STDOUT_FILENO, string.str, string.size);
+  write(STDOUT_FILENO, "\n", 1);
+}
+
+//~ Error
+internal void _error_message_and_exit(const char8 *file, int line, const char8 *func, const char8 *fmt, ...) {
+  char8 buffer[1024];
+  va_list args;
+
+  va_start(args, fmt);
+  vsnprintf((char*)buffer, sizeof(buffer), (char*)fmt, args);
+  va_end(args);
+
+  char8 detailed_buffer[2048];
+  MemoryZero(detailed_buffer, 2048);
+  s32 len = snprintf((char*)detailed_buffer, sizeof(detailed_buffer), "Error at %s:%d in %s\n%s\n", file, line, func, buffer);
+
+  if (ErrorLogFile.size > 0) {
+    file_append(ErrorLogFile, detailed_buffer, len);
+  }
+
+  fputs((char*)detailed_buffer, stderr);
+  exit(1);
+}
+
+//~ Entry point
+int main(int argc, char** argv) {
+  thread_context_init_and_attach(&MainThreadContext);
+  Command_Line command_line = command_line_parse(command_line_join(argc, (char8**)argv));
+  entry_point(command_line);
+  return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef FZ_LINUX_H
+#define FZ_LINUX_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+
+// DOC(fz): The platform API is declared in fz_os.h, this header only holds what is Linux specific.
+// Linux builds are always headless, there is no window or OpenGL layer.
+
+///////////////////////
+//~ Threading
+typedef struct _Linux_Thread_Start {
+  thread_func* start;
+  void* context;
+} _Linux_Thread_Start;
+
+internal void* _linux_thread_entry(void* parameter);
+
+///////////////////////
+//~ File handling
+// NOTE(fz): glibc doesn't wrap getdents64 everywhere, so the record is declared here and the syscall is made directly.
+typedef struct _Linux_Dirent64 {
+  u64  d_ino;
+  s64  d_off;
+  u16  d_reclen;
+  u8   d_type;
+  char d_name[];
+} _Linux_Dirent64;
+
+#define LINUX_DIRENT_BUFFER_SIZE Kilobytes(32)
+#define LINUX_DT_UNKNOWN 0
+#define LINUX_DT_DIR     4
+#define LINUX_DT_REG     8
+
+internal char8* _linux_cstring_from_path(Arena* arena, String8 path);
+internal u32    _linux_file_write(String8 file_path, s32 flags, char8* data, u64 data_size);
+
+///////////////////////
+//~ File watching
+// NOTE(fz): inotify isn't recursive. Every directory has its own watch descriptor, kept here to turn events back into paths.
+typedef struct _Linux_Watch_Directory {
+  struct _Linux_Watch_Directory* next;
+  s32 descriptor;
+  String8 path;
+} _Linux_Watch_Directory;
+
+#define LINUX_WATCH_MASK        (IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE | IN_ONLYDIR)
+#define LINUX_WATCH_BUFFER_SIZE Kilobytes(16)
+
+internal void _linux_watch_add_tree(File_Watch* watch, String8 directory_path); /* Watches directory_path and every directory under it */
+internal void _linux_watch_add(File_Watch* watch, String8 directory_path);
+internal void _linux_watch_visit(String8 directory_path, String8 name, b32 is_directory, void* context); /* Queues subdirectories, skips files */
+
+///////////////////////
+//~ Local sockets
+internal socklen_t _linux_socket_address(struct sockaddr_un* address, String8 name); /* Abstract namespace address, returns its length */
+
+#endif // FZ_LINUX_H
@@ -1,7 +1,9 @@
+#if !FZ_HEADLESS
 internal void application_stop() {
   IsApplicationRunning = false;
   PostQuitMessage(0);
 }
+#endif
 
 internal void* memory_reserve(u64 size) {
   void* result = VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
@@ -27,6 +29,85 @@ internal u64 memory_get_page_size() {
   return(sysinfo.dwPageSize);
 }
 
+//~ Threading
+internal DWORD WINAPI _win32_thread_entry(LPVOID parameter) {
+  _Win32_Thread_Start start = *(_Win32_Thread_Start*)parameter;
+  HeapFree(GetProcessHeap(), 0, parameter);
+
+  Thread_Context thread_context;
+  thread_context_init_and_attach(&thread_context);
+  u64 result = start.start(start.context);
+  thread_context_free();
+  return (DWORD)result;
+}
+
+internal Thread thread_create(thread_func* start, void* context) {
+  Thread result = {0};
+  _Win32_Thread_Start* parameter = HeapAlloc(GetProcessHeap(), 0, sizeof(_Win32_Thread_Start));
+  parameter->start   = start;
+  parameter->context = context;
+
+  HANDLE handle = CreateThread(NULL, 0, _win32_thread_entry, parameter, 0, NULL);
+  if (handle == NULL) {
+    HeapFree(GetProcessHeap(), 0, parameter);
+    ERROR_MESSAGE_AND_EXIT("CreateThread failed with error: %lu", GetLastError());
+  }
+  result.v[0] = (u64)handle;
+  return result;
+}
+
+internal void thread_wait_for_join(Thread* other) {
+  HANDLE handle = (HANDLE)other->v[0];
+  WaitForSingleObject(handle, INFINITE);
+  CloseHandle(handle);
+  other->v[0] = 0;
+}
+
+internal void thread_wait_for_join_all(Thread** threads, u32 count) {
+  for (u32 i = 0; i < count; i += 1) {
+    thread_wait_for_join(threads[i]);
+  }
+}
+
+internal void thread_wait_for_join_any(Thread** threads, u32 count) {
+  Arena_Temp scratch = scratch_begin(0, 0);
+  HANDLE* handles = ArenaPush(scratch.arena, HANDLE, count);
+  for (u32 i = 0; i < count; i += 1) {
+    handles[i] = (HANDLE)threads[i]->v[0];
+  }
+  DWORD index = WaitForMultipleObjects(count, handles, FALSE, INFINITE) - WAIT_OBJECT_0;
+  if (index < count) {
+    CloseHandle(handles[index]);
+    threads[index]->v[0] = 0;
+  }
+  scratch_end(&scratch);
+}
+
+internal u32 thread_get_core_count() {
+  SYSTEM_INFO sysinfo = {0};
+  GetSystemInfo(&sysinfo);
+  return (u32)sysinfo.dwNumberOfProcessors;
+}
+
+internal void thread_yield() {
+  SwitchToThread();
+}
+
+internal void thread_sleep_milliseconds(u32 milliseconds) {
+  Sleep(milliseconds);
+}
+
+//~ Time
+internal u64 time_now_microseconds() {
+  local_persist LARGE_INTEGER frequency = {0};
+  if (frequency.QuadPart == 0) {
+    QueryPerformanceFrequency(&frequency);
+  }
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return (u64)((counter.QuadPart * Million(1)) / frequency.QuadPart);
+}
+
 //~ File handling
 internal HANDLE _win32_get_file_handle_read(String8 file_path) {
   Arena_Temp scratch = scratch_begin(0,0);
@@ -85,93 +166,38 @@ internal u64 file_get_last_modified_time(String8 file_path) {
   return result;
 }
 
-internal b32 file_has_extension(String8 filename, String8 ext) {
-  if (filename.size < ext.size + 1)  return false;
-  if (filename.str[filename.size - ext.size] != '.')  return false;
-  for (u64 i = 0; i < ext.size; i++) {
-    if (tolower(filename.str[filename.size - ext.size + i]) != tolower(ext.str[i])) {
-      return false;
-    }
+internal b32 directory_visit(String8 directory_path, directory_visit_func* visit, void* context) {
+  // NOTE(fz): Stack buffers only, visit may be pushing into this thread's scratch arena.
+  WCHAR search[WIN32_PATH_CAPACITY];
+  s32 length = MultiByteToWideChar(CP_UTF8, 0, (char*)directory_path.str, (s32)directory_path.size, search, WIN32_PATH_CAPACITY - 3);
+  if (length <= 0) {
+    return false;
   }
-  return true;
-}
+  search[length++] = L'\\';
+  search[length++] = L'*';
+  search[length]   = L'\0';
 
-internal String8_List file_get_all_file_paths_recursively(Arena* arena, String8 path) {
-  String8_List result = {0};
-  Arena_Temp scratch = scratch_begin(0, 0);
-
-  if (!path_is_directory(path)) {
-    printf("Path '%s' is not a directory.\n", path.str);
-    scratch_end(&scratch);
-    return result;
+  // Basic info skips building the 8.3 short name, large fetch gets more entries per call into the kernel
+  WIN32_FIND_DATAW find_data;
+  HANDLE find_handle = FindFirstFileExW(search, FindExInfoBasic, &find_data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+  if (find_handle == INVALID_HANDLE_VALUE) {
+    return false;
   }
 
-  String8_List dir_queue = {0};
-  string8_list_push(scratch.arena, &dir_queue, path);
-
-  while (dir_queue.node_count > 0) {
-    String8 current_dir = string8_list_pop(&dir_queue);
-    String16 current_dir16 = string16_from_string8(scratch.arena, current_dir);
-    if (current_dir16.size == 0) continue;
-
-    // search_path = current_dir16 + L"\*"
-    String16 search_path = {
-      current_dir16.size + 2,
-      ArenaPushNoZero(scratch.arena, wchar_t, current_dir16.size + 3)
-    };
-    memcpy(search_path.str, current_dir16.str, current_dir16.size * sizeof(wchar_t));
-    search_path.str[current_dir16.size]     = L'\\';
-    search_path.str[current_dir16.size + 1] = L'*';
-    search_path.str[current_dir16.size + 2] = L'\0';
+  char8 name_buffer[MAX_PATH * 3];
+  do {
+    s32 size = WideCharToMultiByte(CP_UTF8, 0, find_data.cFileName, -1, (char*)name_buffer, sizeof(name_buffer), NULL, NULL);
+    if (size <= 1) continue;
 
-    WIN32_FIND_DATAW find_data;
-    HANDLE find_handle = FindFirstFileW(search_path.str, &find_data);
-    if (find_handle == INVALID_HANDLE_VALUE) continue;
-
-    do {
-      if (wcscmp(find_data.cFileName, L".") == 0 || wcscmp(find_data.cFileName, L"..") == 0) {
-        continue;
-      }
-
-      String16 filename16 = {0, find_data.cFileName};
-      while (filename16.str[filename16.size] != L'\0') filename16.size++;
-
-      String8 filename8 = string8_from_string16(scratch.arena, filename16);
-      if (filename8.size == 0) continue;
-
-      u64 full_path_size = current_dir.size + 1 + filename8.size;
-      char8* full_path_str = ArenaPushNoZero(scratch.arena, char8, full_path_size + 1);
-      memcpy(full_path_str, current_dir.str, current_dir.size);
-      full_path_str[current_dir.size] = '\\';
-      memcpy(full_path_str + current_dir.size + 1, filename8.str, filename8.size);
-      full_path_str[full_path_size] = '\0';
-
-      String8 full_path = {full_path_size, full_path_str};
-      b32 is_directory = HasFlags(find_data.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY);
-
-      if (is_directory) {
-        string8_list_push(scratch.arena, &dir_queue, full_path);
-      } else {
-        String8 normalized_path = path_new(arena, full_path);
-        string8_list_push(arena, &result, normalized_path);
-      }
-
-    } while (FindNextFileW(find_handle, &find_data));
-
-    FindClose(find_handle);
-  }
-
-  scratch_end(&scratch);
-  return result;
-}
+    String8 name = string8_new((u64)size - 1, name_buffer);
+    if (string8_equal(name, Str8(".")) || string8_equal(name, Str8(".."))) {
+      continue;
+    }
+    visit(directory_path, name, HasFlags(find_data.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY), context);
+  } while (FindNextFileW(find_handle, &find_data));
 
-internal String8 path_new(Arena* arena, String8 input) {
-  char8* data = ArenaPush(arena, char8, input.size);
-  for (u64 i = 0; i < input.size; i++) {
-    char8 c = input.str[i];
-    data[i] = (c == '/' || c == '\\') ? '\\' : c;
-  }
-  return (String8){ .size = input.size, .str = data };
+  FindClose(find_handle);
+  return true;
 }
 
 internal b32 path_create_as_directory(String8 path) {
@@ -236,6 +262,12 @@ internal b32 path_is_directory(String8 path) {
   return result;;
 }
 
+internal String8 path_get_executable() {
+  local_persist char8 buffer[MAX_PATH];
+  DWORD len = GetModuleFileNameA(0, buffer, MAX_PATH);
+  return (String8){ .size = len, .str = buffer };
+}
+
 internal String8 path_get_working_directory(void) {
   static char8 buffer[MAX_PATH];
   DWORD len = GetCurrentDirectoryA(MAX_PATH, buffer);
@@ -245,90 +277,6 @@ internal String8 path_get_working_directory(void) {
   return (String8){ .size = len, .str = buffer };
 }
 
-internal String8 path_get_file_name(String8 path) {
-  u64 last_sep = 0;
-  for (u64 i = 0; i < path.size; i++) {
-    if (path.str[i] == '\\' || path.str[i] == '/') {
-      last_sep = i + 1;
-    }
-  }
-  return (String8){
-    .str = path.str + last_sep,
-    .size = path.size - last_sep
-  };
-}
-
-internal String8 path_get_file_name_no_ext(String8 path) {
-  String8 file = path_get_file_name(path);
-
-  u64 dot = file.size;
-  for (u64 i = 0; i < file.size; i++) {
-    if (file.str[i] == '.') {
-      dot = i;
-      break;
-    }
-  }
-
-  return (String8){
-    .str = file.str,
-    .size = dot
-  };
-}
-
-internal String8 path_join(Arena* arena, String8 a, String8 b) {
-  b32 a_ends_with_sep   = (a.size > 0 && (a.str[a.size - 1] == '/' || a.str[a.size - 1] == '\\'));
-  b32 b_starts_with_sep = (b.size > 0 && (b.str[0] == '/' || b.str[0] == '\\'));
-
-  u64 total_size = a.size + b.size + 1; // +1 in case we need to insert a separator
-  if (a_ends_with_sep && b_starts_with_sep) {
-    total_size -= 1; // we’ll skip one of the slashes
-  }
-
-  char8* data = ArenaPush(arena, char8, total_size);
-  u64 pos = 0;
-
-  // Copy 'a'
-  MemoryCopy(data + pos, a.str, a.size);
-  pos += a.size;
-
-  // Handle slash insertion/removal
-  if (!a_ends_with_sep && !b_starts_with_sep && a.size > 0 && b.size > 0) {
-    data[pos++] = '\\';
-  } else if (a_ends_with_sep && b_starts_with_sep) {
-    b.str += 1;
-    b.size -= 1;
-  }
-
-  // Copy 'b'
-  MemoryCopy(data + pos, b.str, b.size);
-  pos += b.size;
-
-  return (String8){ .size = pos, .str = data };
-}
-
-internal String8 path_get_current_directory_name(String8 path) {
-  String8 result = {0};
-  u64 index = 0;
-  if (string8_find_last(path, Str8("\\"), &index)) {
-    result = string8_slice(path, index+1, path.size);
-  }
-  return result;
-}
-
-internal String8 path_dirname(String8 path) {
-  u64 last_sep = 0;
-  for (u64 i = 0; i < path.size; i++) {
-    if (path.str[i] == '/' || path.str[i] == '\\') {
-      last_sep = i;
-    }
-  }
-
-  return (String8){
-    .size = last_sep,
-    .str  = path.str,
-  };
-}
-
 internal b32 file_exists(String8 file_path) {
   b32 result = 0;
   Arena_Temp scratch = scratch_begin(0,0);
@@ -435,6 +383,15 @@ internal b32 file_wipe(String8 file_path) {
   return true;
 }
 
+internal b32 file_rename(String8 from_path, String8 to_path) {
+  Arena_Temp scratch = scratch_begin(0,0);
+  char8* from = cstring_from_string8(scratch.arena, from_path);
+  char8* to   = cstring_from_string8(scratch.arena, to_path);
+  b32 result  = (MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0);
+  scratch_end(&scratch);
+  return result;
+}
+
 internal u32 file_size(String8 file_path) {
   u32 result = 0;
   if (!file_exists(file_path)) {
@@ -450,46 +407,301 @@ internal u32 file_size(String8 file_path) {
 
 internal File_Data file_load(Arena* arena, String8 file_path) {
   File_Data result = { 0 };
-  if (!file_exists(file_path)) {
-    printf("Error: file_load failed because file %s doesn't exist\n", file_path.str);
-    return result;
-  }
 
   HANDLE file_handle = _win32_get_file_handle_read(file_path);
   if (file_handle == NULL) {
     return result;
   }
   
-  u32 size    = file_size(file_path);
-  char8* data = ArenaPush(arena, char8, size);
-  MemoryZero(data, size);
+  LARGE_INTEGER size = {0};
+  if (!GetFileSizeEx(file_handle, &size)) {
+    CloseHandle(file_handle);
+    return result;
+  }
 
-  if (!ReadFile(file_handle, data, size, NULL, NULL)) {
+  char8* data = ArenaPushNoZero(arena, char8, (u64)size.QuadPart);
+  DWORD bytes_read = 0;
+  if (!ReadFile(file_handle, data, (DWORD)size.QuadPart, &bytes_read, NULL)) {
     DWORD error = GetLastError();  
     printf("Error: %lu in file_load.\n", error);
+    CloseHandle(file_handle);
     return result;
   }
   result.path = file_path;
   result.data.str = data;
-  result.data.size = size;
+  result.data.size = bytes_read;
   
   CloseHandle(file_handle);
   return result;
 }
 
-internal void file_list_push(Arena* arena, File_List* list, File_Data file) {
-  File_Node* node = ArenaPush(arena, File_Node, sizeof(File_Node));
-  
-  node->value = file;
-  if (!list->first && !list->last) {
-    list->first = node;
-    list->last  = node;
-  } else {
-    list->last->next = node;
-    list->last       = node;
+internal File_Map file_map_open(String8 file_path) {
+  File_Map result = { 0 };
+  result.path = file_path;
+
+  HANDLE file_handle = _win32_get_file_handle_read(file_path);
+  if (file_handle == NULL) {
+    return result;
+  }
+
+  LARGE_INTEGER size = {0};
+  if (!GetFileSizeEx(file_handle, &size)) {
+    CloseHandle(file_handle);
+    return result;
+  }
+  if (size.QuadPart == 0) {
+    // NOTE(fz): Empty files can't be mapped. They are still a valid, empty, File_Map.
+    CloseHandle(file_handle);
+    result.is_readable = true;
+    return result;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL) {
+    CloseHandle(file_handle);
+    return result;
+  }
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == NULL) {
+    CloseHandle(mapping);
+    CloseHandle(file_handle);
+    return result;
+  }
+
+  result.data.str    = (char8*)view;
+  result.data.size   = (u64)size.QuadPart;
+  result.is_readable = true;
+  result.handles[0]  = (u64)file_handle;
+  result.handles[1]  = (u64)mapping;
+  return result;
+}
+
+internal void file_map_close(File_Map* map) {
+  if (map->data.str) {
+    UnmapViewOfFile(map->data.str);
+  }
+  if (map->handles[1]) {
+    CloseHandle((HANDLE)map->handles[1]);
+  }
+  if (map->handles[0]) {
+    CloseHandle((HANDLE)map->handles[0]);
+  }
+  MemoryZeroStruct(map);
+}
+
+//~ File watching
+internal File_Watch file_watch_open(String8 directory_path) {
+  File_Watch result = { 0 };
+  Arena_Temp scratch = scratch_begin(0, 0);
+  char8* cstring = cstring_from_string8(scratch.arena, directory_path);
+  HANDLE directory = CreateFileA(cstring, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+  scratch_end(&scratch);
+  if (directory == INVALID_HANDLE_VALUE) {
+    printf("Error: %lu in file_watch_open.\n", GetLastError());
+    return result;
+  }
+
+  result.arena = arena_init();
+  result.path  = string8_copy(result.arena, directory_path);
+  OVERLAPPED* overlapped = ArenaPush(result.arena, OVERLAPPED, 1);
+  overlapped->hEvent     = CreateEventA(NULL, TRUE, FALSE, NULL);
+  result.handles[0] = (u64)directory;
+  result.handles[1] = (u64)overlapped;
+  result.handles[2] = (u64)ArenaPush(result.arena, u8, WIN32_WATCH_BUFFER_SIZE);
+  _win32_watch_issue(&result);
+  return result;
+}
+
+internal String8_List file_watch_read(Arena* arena, File_Watch* watch) {
+  String8_List result = { 0 };
+  if (watch->arena == NULL) {
+    return result;
+  }
+
+  HANDLE directory       = (HANDLE)watch->handles[0];
+  OVERLAPPED* overlapped = (OVERLAPPED*)watch->handles[1];
+  u8* buffer             = (u8*)watch->handles[2];
+  DWORD bytes = 0;
+  // NOTE(fz): Between two reads the OS keeps collecting changes for the handle, nothing is lost while no read is pending.
+  while (GetOverlappedResult(directory, overlapped, &bytes, FALSE)) {
+    if (bytes == 0) {
+      // The buffer overflowed and the changes were dropped, anything under the root may have changed
+      string8_list_push(arena, &result, watch->path);
+    }
+
+    for (u64 offset = 0; offset < bytes;) {
+      FILE_NOTIFY_INFORMATION* information = (FILE_NOTIFY_INFORMATION*)(buffer + offset);
+      String16 name = { information->FileNameLength / sizeof(WCHAR), (char16*)information->FileName };
+      String8 path  = path_join(arena, watch->path, string8_from_string16(arena, name));
+      string8_list_push(arena, &result, path);
+      if (information->NextEntryOffset == 0) break;
+      offset += information->NextEntryOffset;
+    }
+
+    ResetEvent(overlapped->hEvent);
+    if (!_win32_watch_issue(watch)) break;
+  }
+
+  return result;
+}
+
+internal void file_watch_close(File_Watch* watch) {
+  if (watch->arena != NULL) {
+    OVERLAPPED* overlapped = (OVERLAPPED*)watch->handles[1];
+    CancelIo((HANDLE)watch->handles[0]);
+    CloseHandle((HANDLE)watch->handles[0]);
+    CloseHandle(overlapped->hEvent);
+    arena_free(watch->arena);
+  }
+  MemoryZeroStruct(watch);
+}
+
+internal b32 _win32_watch_issue(File_Watch* watch) {
+  b32 result = ReadDirectoryChangesW((HANDLE)watch->handles[0], (void*)watch->handles[2], WIN32_WATCH_BUFFER_SIZE, TRUE, WIN32_WATCH_FILTER, NULL, (OVERLAPPED*)watch->handles[1], NULL);
+  return result;
+}
+
+//~ Local sockets
+internal Local_Socket local_socket_listen(String8 name) {
+  Local_Socket result = { 0 };
+  _Win32_Pipe_Listener* listener = calloc(1, sizeof(_Win32_Pipe_Listener));
+  snprintf((char*)listener->name, sizeof(listener->name), "\\\\.\\pipe\\%.*s", (s32)name.size, name.str);
+
+  // NOTE(fz): The first instance claims the name, a second listener on the same name fails here.
+  listener->pipe = _win32_pipe_create(listener->name, true);
+  if (listener->pipe == INVALID_HANDLE_VALUE) {
+    free(listener);
+    return result;
+  }
+  listener->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+  result.handles[0] = (u64)listener;
+  result.handles[1] = true; // Listener, not a connection
+  return result;
+}
+
+internal Local_Socket local_socket_accept(Local_Socket* server, u32 timeout_milliseconds) {
+  Local_Socket result = { 0 };
+  if (!local_socket_is_valid(server)) {
+    return result;
+  }
+
+  _Win32_Pipe_Listener* listener = (_Win32_Pipe_Listener*)server->handles[0];
+  if (!listener->is_pending) {
+    ResetEvent(listener->overlapped.hEvent);
+    if (!ConnectNamedPipe(listener->pipe, &listener->overlapped)) {
+      DWORD error = GetLastError();
+      if (error == ERROR_IO_PENDING) {
+        listener->is_pending = true;
+      } else if (error != ERROR_PIPE_CONNECTED) {
+        return result;
+      }
+    }
+  }
+
+  if (listener->is_pending) {
+    // A connect still pending at the timeout is picked up by the next accept
+    if (WaitForSingleObject(listener->overlapped.hEvent, timeout_milliseconds) != WAIT_OBJECT_0) {
+      return result;
+    }
+    listener->is_pending = false;
+    DWORD unused = 0;
+    if (!GetOverlappedResult(listener->pipe, &listener->overlapped, &unused, FALSE)) {
+      DisconnectNamedPipe(listener->pipe);
+      return result;
+    }
+  }
+
+  result.handles[0] = (u64)listener->pipe;
+  listener->pipe = _win32_pipe_create(listener->name, false);
+  return result;
+}
+
+internal Local_Socket local_socket_connect(String8 name) {
+  Local_Socket result = { 0 };
+  char8 pipe_name[WIN32_PIPE_NAME_SIZE];
+  snprintf((char*)pipe_name, sizeof(pipe_name), "\\\\.\\pipe\\%.*s", (s32)name.size, name.str);
+
+  HANDLE pipe = CreateFileA(pipe_name, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+  if (pipe == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PIPE_BUSY && WaitNamedPipeA(pipe_name, 1000)) {
+    pipe = CreateFileA(pipe_name, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+  }
+  if (pipe == INVALID_HANDLE_VALUE) {
+    return result;
+  }
+
+  result.handles[0] = (u64)pipe;
+  return result;
+}
+
+internal b32 local_socket_is_valid(Local_Socket* socket) {
+  return socket->handles[0] != 0;
+}
+
+internal String8 local_socket_read(Arena* arena, Local_Socket* socket, u64 max_size) {
+  String8 result = { 0 };
+  if (!local_socket_is_valid(socket) || socket->handles[1]) {
+    return result;
+  }
+
+  result.str  = ArenaPushNoZero(arena, char8, max_size);
+  result.size = _win32_pipe_transfer((HANDLE)socket->handles[0], result.str, (u32)Min(max_size, U32_MAX), false);
+  arena_pop(arena, max_size - result.size);
+  return result;
+}
+
+internal b32 local_socket_write(Local_Socket* socket, String8 data) {
+  if (!local_socket_is_valid(socket) || socket->handles[1]) {
+    return false;
   }
-  list->node_count += 1;
-  list->total_size += node->value.data.size;
+
+  u64 total = 0;
+  while (total < data.size) {
+    u32 bytes = _win32_pipe_transfer((HANDLE)socket->handles[0], data.str + total, (u32)Min(data.size - total, U32_MAX), true);
+    if (bytes == 0) return false;
+    total += bytes;
+  }
+  return true;
+}
+
+internal void local_socket_close(Local_Socket* socket) {
+  if (local_socket_is_valid(socket)) {
+    if (socket->handles[1]) {
+      _Win32_Pipe_Listener* listener = (_Win32_Pipe_Listener*)socket->handles[0];
+      CancelIo(listener->pipe);
+      CloseHandle(listener->pipe);
+      CloseHandle(listener->overlapped.hEvent);
+      free(listener);
+    } else {
+      // Closing a pipe drops what the peer hasn't read yet
+      FlushFileBuffers((HANDLE)socket->handles[0]);
+      CloseHandle((HANDLE)socket->handles[0]);
+    }
+  }
+  MemoryZeroStruct(socket);
+}
+
+internal HANDLE _win32_pipe_create(char8* pipe_name, b32 is_first) {
+  DWORD open_mode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (is_first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+  DWORD pipe_mode = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS;
+  HANDLE result = CreateNamedPipeA(pipe_name, open_mode, pipe_mode, PIPE_UNLIMITED_INSTANCES, WIN32_PIPE_BUFFER_SIZE, WIN32_PIPE_BUFFER_SIZE, 0, NULL);
+  return result;
+}
+
+internal u32 _win32_pipe_transfer(HANDLE pipe, void* data, u32 size, b32 is_write) {
+  // NOTE(fz): Pipes are opened overlapped so the listener can time out, every transfer waits on its own event.
+  OVERLAPPED overlapped = { 0 };
+  overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+  BOOL started = is_write ? WriteFile(pipe, data, size, NULL, &overlapped) : ReadFile(pipe, data, size, NULL, &overlapped);
+  DWORD bytes = 0;
+  if (started || GetLastError() == ERROR_IO_PENDING) {
+    if (!GetOverlappedResult(pipe, &overlapped, &bytes, TRUE)) {
+      bytes = 0; // ERROR_BROKEN_PIPE once the peer closed
+    }
+  }
+  CloseHandle(overlapped.hEvent);
+  return (u32)bytes;
 }
 
 internal void println_string(String8 string) {
@@ -521,4 +733,13 @@ internal void _error_message_and_exit(const char8 *file, int line, const char8 *
 
   MessageBoxA(0, detailed_buffer, "ERROR: fz_std", MB_OK);
   ExitProcess(1);
-}
\ No newline at end of file
+}
+
+#if FZ_HEADLESS
+int main(int argc, char** argv) {
+  thread_context_init_and_attach(&MainThreadContext);
+  Command_Line command_line = command_line_parse(command_line_join(argc, (char8**)argv));
+  entry_point(command_line);
+  return 0;
+}
+#endif
@@ -9,101 +9,48 @@
 # include <windows.h>
 #endif
 
+// DOC(fz): The platform API is declared in fz_os.h, this header only holds what is Win32 specific.
+
 ///////////////////////
 //~ Win32
+#if !FZ_HEADLESS
 internal void application_stop();
-
-///////////////////////
-//~ Memory
-internal void* memory_reserve(u64 size);
-internal b32   memory_commit(void* memory, u64 size);
-internal void  memory_decommit(void* memory, u64 size);
-internal void  memory_release(void* memory, u64 size);
-internal u64   memory_get_page_size();
+#endif
 
 ///////////////////////
 //~ Threading
-typedef u64 thread_func(void* context); 
+typedef struct _Win32_Thread_Start {
+  thread_func* start;
+  void* context;
+} _Win32_Thread_Start;
 
-typedef struct Thread {
-  u64 v[1];
-} Thread;
-
-internal Thread thread_create(thread_func* start, void* context);
-internal void   thread_wait_for_join(Thread* other);
-internal void   thread_wait_for_join_all(Thread** threads, u32 count);
-internal void   thread_wait_for_join_any(Thread** threads, u32 count);
+internal DWORD WINAPI _win32_thread_entry(LPVOID parameter);
 
 ///////////////////////
 //~ File handling
-
-typedef enum {
-  FileFlag_None       = 0,
-  FileFlag_WhiteList  = 1 << 0,
-  FileFlag_CFiles     = 1 << 2,
-  FileFlag_HFiles     = 1 << 3,
-  FileFlag_Dirs       = 1 << 4,
-  FileFlag_DotFiles   = 1 << 5,
-  FileFlag_DotDirs    = 1 << 6,
-} FileFlags;
-
-typedef struct File_Data {
-  String8 path;
-  String8 data;
-} File_Data;
-
-typedef struct File_Node {
-  struct File_Node* next;
-  File_Data value;
-} File_Node;
-
-typedef struct File_List {
-  File_Node* first;
-  File_Node* last;
-  u64 node_count;
-  u64 total_size;
-} File_List;
-
-internal void      file_list_push(Arena* arena, File_List* list, File_Data file);
-
-internal b32          file_create(String8 file_path); /* Creates file. If file exists, returns true anyway. */
-internal b32          file_exists(String8 file_path); /* Returns true if file exists */
-internal u32          file_overwrite(String8 file_path, char8* data, u64 data_size);
-internal u32          file_append(String8 file_path, char8* data, u64 data_size);
-internal b32          file_wipe(String8 file_path);
-internal u32          file_size(String8 file_path);
-internal File_Data    file_load(Arena* arena, String8 file_path);
-internal b32          file_has_extension(String8 filename, String8 ext);
-internal u64          file_get_last_modified_time(String8 file_path);
-internal String8_List file_get_all_file_paths_recursively(Arena* arena, String8 path);
-
-internal b32 directory_create(String8 directory_path);
-internal b32 directory_exists(String8 directory_path);
-
-internal String8 path_new(Arena* arena, String8 path);
-internal b32     path_create_as_directory(String8 path);
-internal b32     path_is_file(String8 path);
-internal b32     path_is_directory(String8 path);
-internal String8 path_get_working_directory();
-internal String8 path_get_file_name(String8 path);
-internal String8 path_get_file_name_no_ext(String8 path);
-internal String8 path_join(Arena* arena, String8 a, String8 b);
-internal String8 path_get_current_directory_name(String8 path);
-internal String8 path_dirname(String8 path);
-
-///////////////////////
-//~ Logging 
-internal void println_string(String8 string); // TODO(fz): This should be abstracted into a more generic win32_print that then String can use to implement it's own print_string
+#define WIN32_PATH_CAPACITY 4096 // UTF-16 units for a directory path being listed
 
 ///////////////////////
-//~ Error
-// TODO(Fz): I'm not sure if I like this macro. Feels constrained and unecessary
-String8 ErrorLogFile = { 0 };
-internal void set_error_log_file(String8 file_path) {
-  ErrorLogFile = file_path;
-}
+//~ File watching
+#define WIN32_WATCH_BUFFER_SIZE Kilobytes(64) // NOTE(fz): Changes past this between two reads are dropped and reported as the whole tree
+#define WIN32_WATCH_FILTER      (FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE)
 
-#define ERROR_MESSAGE_AND_EXIT(fmt, ...) _error_message_and_exit(__FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
-internal void _error_message_and_exit(const char8 *file, int line, const char8 *func, const char8 *fmt, ...);
+internal b32 _win32_watch_issue(File_Watch* watch); /* Starts the next overlapped ReadDirectoryChangesW */
 
-#endif // FZ_WIN32_H
\ No newline at end of file
+///////////////////////
+//~ Local sockets
+#define WIN32_PIPE_NAME_SIZE   256
+#define WIN32_PIPE_BUFFER_SIZE Kilobytes(64)
+
+// The instance a client connects to next. Once connected it is handed out and a new one takes its place
+typedef struct _Win32_Pipe_Listener {
+  HANDLE pipe;
+  OVERLAPPED overlapped; // Of the pending ConnectNamedPipe
+  b32 is_pending;
+  char8 name[WIN32_PIPE_NAME_SIZE];
+} _Win32_Pipe_Listener;
+
+internal HANDLE _win32_pipe_create(char8* pipe_name, b32 is_first);
+internal u32    _win32_pipe_transfer(HANDLE pipe, void* data, u32 size, b32 is_write); /* Blocks, returns the bytes moved, 0 once the peer closed */
+
+#endif // FZ_WIN32_H
@@ -0,0 +1,138 @@
+///////////////
+// Intern table
+internal void intern_init() {
+  Intern_Table* table = &InternTable;
+  if (table->is_ready) {
+    return;
+  }
+
+  MemoryZeroStruct(table);
+  for (u32 i = 0; i < INTERN_SHARD_COUNT; i += 1) {
+    Intern_Shard* shard = &table->shards[i];
+    shard->arena    = arena_init();
+    shard->entries  = ArenaPush(shard->arena, Intern_Entry, INTERN_SHARD_CHUNK_SIZE);
+    shard->capacity = INTERN_SHARD_CHUNK_SIZE;
+    shard->count    = 1;
+
+    shard->slots_arena    = arena_init();
+    shard->slot_tables[0] = ArenaPush(shard->slots_arena, u32, INTERN_SLOTS_FIRST_COUNT);
+  }
+  table->is_ready = true;
+
+  // NOTE(fz): Flags are set before any worker exists and never change, so readers need no lock for them either.
+  for (u32 i = 0; i < ArrayCount(intern_predefined); i += 1) {
+    Intern_Id id = intern_string8(string8_from_cstring((char8*)intern_predefined[i].value));
+    InternTable.shards[id & (INTERN_SHARD_COUNT - 1)].entries[id >> INTERN_SHARD_BITS].flags |= intern_predefined[i].flags;
+    if (i < Intern_Name_Count) {
+      InternNames[i] = id;
+    }
+  }
+}
+
+internal Intern_Id intern_string8(String8 value) {
+  Assert(InternTable.is_ready);
+  // NOTE(fz): The top bits pick the shard, the low bits the slot inside it, so the two never correlate.
+  u64 hash = cache_hash(value);
+  u32 shard_index = (u32)(hash >> (64 - INTERN_SHARD_BITS));
+  Intern_Shard* shard = &InternTable.shards[shard_index];
+
+  u32 index = intern_shard_find(shard, value, hash);
+  if (index == 0) {
+    intern_shard_lock(shard);
+    index = intern_shard_get(shard, value, hash);
+    intern_shard_unlock(shard);
+  }
+  Assert(index < (1u << (32 - INTERN_SHARD_BITS)));
+
+  Intern_Id result = (index << INTERN_SHARD_BITS) | shard_index;
+  return result;
+}
+
+internal String8 intern_value(Intern_Id id) {
+  Assert(id != 0);
+  String8 result = InternTable.shards[id & (INTERN_SHARD_COUNT - 1)].entries[id >> INTERN_SHARD_BITS].value;
+  return result;
+}
+
+internal Intern_Flags intern_flags(Intern_Id id) {
+  Intern_Flags result = Intern_Flag_None;
+  if (id != 0) {
+    result = InternTable.shards[id & (INTERN_SHARD_COUNT - 1)].entries[id >> INTERN_SHARD_BITS].flags;
+  }
+  return result;
+}
+
+///////////////
+// Intern table help
+internal void intern_shard_lock(Intern_Shard* shard) {
+  while (atomic_compare_exchange_u32(&shard->lock, 0, 1) != 0) {
+    while (atomic_load_u32(&shard->lock) != 0) {
+      cpu_pause();
+    }
+  }
+}
+
+internal void intern_shard_unlock(Intern_Shard* shard) {
+  atomic_store_u32(&shard->lock, 0);
+}
+
+internal u32 intern_shard_find(Intern_Shard* shard, String8 value, u64 hash) {
+  // NOTE(fz): A writer may be adding to this table or growing past it. Either way what a slot points to was written
+  // before the slot, and a name added after the table was replaced is a miss here that intern_shard_get finds.
+  u32 generation = atomic_load_u32(&shard->generation);
+  u32* slots     = shard->slot_tables[generation];
+  u32 mask       = (INTERN_SLOTS_FIRST_COUNT << generation) - 1;
+  u32 slot       = (u32)hash & mask;
+  for (u32 index = atomic_load_u32(&slots[slot]); index != 0; index = atomic_load_u32(&slots[slot])) {
+    Intern_Entry* entry = &shard->entries[index];
+    if (entry->hash == hash && string8_equal(entry->value, value)) {
+      return index;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return 0;
+}
+
+internal u32 intern_shard_get(Intern_Shard* shard, String8 value, u64 hash) {
+  u32 generation = shard->generation;
+  u32* slots     = shard->slot_tables[generation];
+  u32 mask       = (INTERN_SLOTS_FIRST_COUNT << generation) - 1;
+  u32 slot       = (u32)hash & mask;
+  while (slots[slot] != 0) {
+    Intern_Entry* entry = &shard->entries[slots[slot]];
+    if (entry->hash == hash && string8_equal(entry->value, value)) {
+      return slots[slot];
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  if (shard->count == shard->capacity) {
+    Intern_Entry* chunk = ArenaPush(shard->arena, Intern_Entry, INTERN_SHARD_CHUNK_SIZE);
+    Assert(chunk == shard->entries + shard->capacity);
+    shard->capacity += INTERN_SHARD_CHUNK_SIZE;
+  }
+  u32 result = shard->count;
+  Intern_Entry* entry = &shard->entries[result];
+  entry->value = string8_copy(shard->slots_arena, value);
+  entry->hash  = hash;
+  entry->flags = Intern_Flag_None;
+  shard->count += 1;
+  atomic_store_u32(&slots[slot], result);
+
+  // NOTE(fz): Kept at most half full so probing stays short. The next table is filled before readers are sent to it.
+  if (shard->count * 2 > (mask + 1)) {
+    Assert(generation + 1 < INTERN_GENERATION_COUNT);
+    u32 next_mask = ((mask + 1) * 2) - 1;
+    u32* next     = ArenaPush(shard->slots_arena, u32, next_mask + 1);
+    for (u32 other = 1; other < shard->count; other += 1) {
+      u32 at = (u32)shard->entries[other].hash & next_mask;
+      while (next[at] != 0) {
+        at = (at + 1) & next_mask;
+      }
+      next[at] = other;
+    }
+    shard->slot_tables[generation + 1] = next;
+    atomic_store_u32(&shard->generation, generation + 1);
+  }
+  return result;
+}
@@ -0,0 +1,145 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+// DOC(fz): One table for the whole process that gives every distinct identifier a u32 id. The lexer interns each
+// Token_Identifier as it makes it and keeps the id in the token, so the parser, the rules and the symbol index compare
+// names as integers and only read the bytes back (intern_value) to print them. Ids are never freed or reused, so tokens
+// of any file, Document or worker can be compared with each other.
+//
+// Like Symbol_Index, a name lives in one of INTERN_SHARD_COUNT shards picked by the top bits of its hash, and its id
+// holds the shard in the low bits and the entry inside the shard above them. Looking a name up takes no lock: an entry
+// is written before the slot that points to it, and a grown slot table is published only once it is filled. A miss
+// locks the shard, looks again and adds the name. Most identifiers were seen before, so workers rarely lock.
+//
+// Ids are only meaningful inside the process that made them. The cache interns a file's identifiers again on load.
+
+typedef u32 Intern_Id; // 0 is no name
+
+typedef enum Intern_Flags {
+  Intern_Flag_None              = 0,
+  Intern_Flag_Builtin_Type      = 1 << 0, // Identifier to the lexer that names a type: int, size_t
+  Intern_Flag_Builtin_Specifier = 1 << 1, // Identifier to the lexer that doesn't name a type on its own: _Atomic, auto
+  Intern_Flag_C_Type            = 1 << 2, // codebase-types wants a typedef instead
+} Intern_Flags;
+
+// Names the analyzer looks for, their ids are in InternNames once intern_init ran
+typedef enum Intern_Name {
+  Intern_Name_Include = 0,
+  Intern_Name_Define,
+  Intern_Name_Pragma,
+  Intern_Name_Static_Assert,       // _Static_assert
+  Intern_Name_Static_Assert_Macro, // static_assert, <assert.h>
+  Intern_Name_Atomic,
+  Intern_Name_Main,
+  Intern_Name_Internal,
+  Intern_Name_Count,
+} Intern_Name;
+
+typedef struct Intern_Predefined {
+  const char8* value;
+  Intern_Flags flags;
+} Intern_Predefined;
+
+// NOTE(fz): Interned first by intern_init. Entries below Intern_Name_Count line up with Intern_Name.
+// Builtin and <stdint.h>/<stddef.h> names are plain identifiers to the lexer, the parser tells them apart by flag.
+static const Intern_Predefined intern_predefined[] = {
+  [Intern_Name_Include]             = { "include" },
+  [Intern_Name_Define]              = { "define" },
+  [Intern_Name_Pragma]              = { "pragma" },
+  [Intern_Name_Static_Assert]       = { "_Static_assert" },
+  [Intern_Name_Static_Assert_Macro] = { "static_assert" },
+  [Intern_Name_Atomic]              = { "_Atomic", Intern_Flag_Builtin_Specifier },
+  [Intern_Name_Main]                = { "main" },
+  [Intern_Name_Internal]            = { "internal", Intern_Flag_Builtin_Specifier },
+
+  { "char",     Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "short",    Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "int",      Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "long",     Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "float",    Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "double",   Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "signed",   Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "unsigned", Intern_Flag_Builtin_Type | Intern_Flag_C_Type },
+  { "_Bool",     Intern_Flag_Builtin_Type },
+  { "bool",      Intern_Flag_Builtin_Type },
+  { "_Complex",  Intern_Flag_Builtin_Type },
+  { "size_t",    Intern_Flag_Builtin_Type },
+  { "ptrdiff_t", Intern_Flag_Builtin_Type },
+  { "intptr_t",  Intern_Flag_Builtin_Type },
+  { "uintptr_t", Intern_Flag_Builtin_Type },
+  { "wchar_t",   Intern_Flag_Builtin_Type },
+  { "int8_t",    Intern_Flag_Builtin_Type },
+  { "int16_t",   Intern_Flag_Builtin_Type },
+  { "int32_t",   Intern_Flag_Builtin_Type },
+  { "int64_t",   Intern_Flag_Builtin_Type },
+  { "uint8_t",   Intern_Flag_Builtin_Type },
+  { "uint16_t",  Intern_Flag_Builtin_Type },
+  { "uint32_t",  Intern_Flag_Builtin_Type },
+  { "uint64_t",  Intern_Flag_Builtin_Type },
+  // NOTE(fz): fz_core.h types. Casts like (u32)-1 need them known, headers are never read.
+  { "u8",     Intern_Flag_Builtin_Type },
+  { "u16",    Intern_Flag_Builtin_Type },
+  { "u32",    Intern_Flag_Builtin_Type },
+  { "u64",    Intern_Flag_Builtin_Type },
+  { "s8",     Intern_Flag_Builtin_Type },
+  { "s16",    Intern_Flag_Builtin_Type },
+  { "s32",    Intern_Flag_Builtin_Type },
+  { "s64",    Intern_Flag_Builtin_Type },
+  { "f32",    Intern_Flag_Builtin_Type },
+  { "f64",    Intern_Flag_Builtin_Type },
+  { "b8",     Intern_Flag_Builtin_Type },
+  { "b32",    Intern_Flag_Builtin_Type },
+  { "char8",  Intern_Flag_Builtin_Type },
+  { "char16", Intern_Flag_Builtin_Type },
+  { "char32", Intern_Flag_Builtin_Type },
+  { "_Thread_local", Intern_Flag_Builtin_Specifier },
+  { "_Noreturn",     Intern_Flag_Builtin_Specifier },
+  { "auto",          Intern_Flag_Builtin_Specifier },
+  // NOTE(fz): fz_core.h storage macros, static underneath.
+  { "global",        Intern_Flag_Builtin_Specifier },
+  { "local_persist", Intern_Flag_Builtin_Specifier },
+};
+
+typedef struct Intern_Entry {
+  String8 value; // Copied into the shard
+  u64 hash;
+  Intern_Flags flags;
+} Intern_Entry;
+
+#define INTERN_SHARD_BITS        6
+#define INTERN_SHARD_COUNT       (1 << INTERN_SHARD_BITS)
+#define INTERN_SHARD_CHUNK_SIZE  256
+#define INTERN_SLOTS_FIRST_COUNT (INTERN_SHARD_CHUNK_SIZE * 2)
+#define INTERN_GENERATION_COUNT  24 // Slot tables a shard can grow through, far more than 2^26 entries need
+
+typedef struct Intern_Shard {
+  u32 lock;              // Taken to add, never to look up
+  Arena* arena;          // Holds entries only, so an entry never moves while a reader looks at it
+  Intern_Entry* entries; // Index 0 is unused
+  u32 count;
+  u32 capacity;
+
+  Arena* slots_arena;    // Names and slot tables. Old tables stay, a reader may still be probing one
+  u32* slot_tables[INTERN_GENERATION_COUNT]; // Open addressing on the hash, 0 is an empty slot. Table g has INTERN_SLOTS_FIRST_COUNT << g slots
+  u32 generation;        // Table readers probe, stored once the table is filled
+} Intern_Shard;
+
+typedef struct Intern_Table {
+  b32 is_ready;
+  Intern_Shard shards[INTERN_SHARD_COUNT];
+} Intern_Table;
+global Intern_Table InternTable;
+global Intern_Id    InternNames[Intern_Name_Count];
+
+internal void         intern_init();                    /* Builds InternTable with the predefined names. Call before any lexing, on one thread */
+internal Intern_Id    intern_string8(String8 value);    /* Any thread. Id of value, added if new */
+internal String8      intern_value(Intern_Id id);       /* Bytes of the name, live as long as the process */
+internal Intern_Flags intern_flags(Intern_Id id);
+
+// Help
+internal void intern_shard_lock(Intern_Shard* shard);
+internal void intern_shard_unlock(Intern_Shard* shard);
+internal u32  intern_shard_find(Intern_Shard* shard, String8 value, u64 hash); /* Entry index, 0 if missing. Takes no lock */
+internal u32  intern_shard_get(Intern_Shard* shard, String8 value, u64 hash);  /* Adds value if missing, shard must be locked */
+
+#endif // INTERN_H
@@ -1,41 +1,192 @@
+///////////////
+// Character tables
+// NOTE(fz): Bytes that are not listed map to Char_Class_Unknown and lex as a one byte Token_Unknown. Compared to the
+// old chain of checks in next_token this changed three inputs on purpose:
+// - A stray "*/" is Token_Multiply then Token_Divide. It used to reach token_from_comment, which exited the program.
+// - '\v' and '\f' are Token_Unknown. token_from_whitespace used to return an empty token for them without moving on,
+//   so lexing never ended.
+// - Bytes >= 0x80 (UTF-8) stay Token_Unknown, one per byte, as before. They are never part of an identifier.
+global const u8 lexer_char_class[256] = {
+  // Whitespace
+  [' ']  = Char_Class_Whitespace,
+  ['\t'] = Char_Class_Whitespace,
+  ['\n'] = Char_Class_Whitespace,
+  ['\r'] = Char_Class_Whitespace,
+
+  // Identifiers
+  ['a'] = Char_Class_Identifier, ['b'] = Char_Class_Identifier, ['c'] = Char_Class_Identifier,
+  ['d'] = Char_Class_Identifier, ['e'] = Char_Class_Identifier, ['f'] = Char_Class_Identifier,
+  ['g'] = Char_Class_Identifier, ['h'] = Char_Class_Identifier, ['i'] = Char_Class_Identifier,
+  ['j'] = Char_Class_Identifier, ['k'] = Char_Class_Identifier, ['l'] = Char_Class_Identifier,
+  ['m'] = Char_Class_Identifier, ['n'] = Char_Class_Identifier, ['o'] = Char_Class_Identifier,
+  ['p'] = Char_Class_Identifier, ['q'] = Char_Class_Identifier, ['r'] = Char_Class_Identifier,
+  ['s'] = Char_Class_Identifier, ['t'] = Char_Class_Identifier, ['u'] = Char_Class_Identifier,
+  ['v'] = Char_Class_Identifier, ['w'] = Char_Class_Identifier, ['x'] = Char_Class_Identifier,
+  ['y'] = Char_Class_Identifier, ['z'] = Char_Class_Identifier,
+  ['A'] = Char_Class_Identifier, ['B'] = Char_Class_Identifier, ['C'] = Char_Class_Identifier,
+  ['D'] = Char_Class_Identifier, ['E'] = Char_Class_Identifier, ['F'] = Char_Class_Identifier,
+  ['G'] = Char_Class_Identifier, ['H'] = Char_Class_Identifier, ['I'] = Char_Class_Identifier,
+  ['J'] = Char_Class_Identifier, ['K'] = Char_Class_Identifier, ['L'] = Char_Class_Identifier,
+  ['M'] = Char_Class_Identifier, ['N'] = Char_Class_Identifier, ['O'] = Char_Class_Identifier,
+  ['P'] = Char_Class_Identifier, ['Q'] = Char_Class_Identifier, ['R'] = Char_Class_Identifier,
+  ['S'] = Char_Class_Identifier, ['T'] = Char_Class_Identifier, ['U'] = Char_Class_Identifier,
+  ['V'] = Char_Class_Identifier, ['W'] = Char_Class_Identifier, ['X'] = Char_Class_Identifier,
+  ['Y'] = Char_Class_Identifier, ['Z'] = Char_Class_Identifier,
+  ['_'] = Char_Class_Identifier,
+
+  // Numbers
+  ['0'] = Char_Class_Digit, ['1'] = Char_Class_Digit, ['2'] = Char_Class_Digit,
+  ['3'] = Char_Class_Digit, ['4'] = Char_Class_Digit, ['5'] = Char_Class_Digit,
+  ['6'] = Char_Class_Digit, ['7'] = Char_Class_Digit, ['8'] = Char_Class_Digit,
+  ['9'] = Char_Class_Digit,
+
+  // Literals
+  ['"']  = Char_Class_Quote,
+  ['\''] = Char_Class_Apostrophe,
+
+  // Operators
+  ['/'] = Char_Class_Slash,
+  ['+'] = Char_Class_Operator, ['-'] = Char_Class_Operator, ['*'] = Char_Class_Operator,
+  ['%'] = Char_Class_Operator, ['='] = Char_Class_Operator, ['!'] = Char_Class_Operator,
+  ['<'] = Char_Class_Operator, ['>'] = Char_Class_Operator, ['&'] = Char_Class_Operator,
+  ['|'] = Char_Class_Operator, ['^'] = Char_Class_Operator,
+
+  // Single character tokens
+  ['#'] = Char_Class_Single, ['~'] = Char_Class_Single,
+  [';'] = Char_Class_Single, [','] = Char_Class_Single, ['.'] = Char_Class_Single,
+  [':'] = Char_Class_Single, ['?'] = Char_Class_Single,
+  ['('] = Char_Class_Single, [')'] = Char_Class_Single,
+  ['{'] = Char_Class_Single, ['}'] = Char_Class_Single,
+  ['['] = Char_Class_Single, [']'] = Char_Class_Single,
+};
+
+global const u8 lexer_single_token_type[256] = {
+  ['#'] = Token_Preprocessor_Hash,
+  ['~'] = Token_Bit_Not,
+  [';'] = Token_Semicolon,
+  [','] = Token_Comma,
+  ['.'] = Token_Dot,
+  [':'] = Token_Colon,
+  ['?'] = Token_Question,
+  ['('] = Token_Open_Parenthesis,
+  [')'] = Token_Close_Parenthesis,
+  ['{'] = Token_Open_Brace,
+  ['}'] = Token_Close_Brace,
+  ['['] = Token_Open_Bracket,
+  [']'] = Token_Close_Bracket,
+};
+
+// NOTE(fz): KEYWORD_HASH is collision free over the keyword set, so a lookup is one hash and at most one compare.
+// If a keyword is added, the constants in KEYWORD_HASH may have to change to keep every slot unique.
+global const Keyword keyword_table[KEYWORD_TABLE_SIZE] = {
+  [ 1] = { "do",       2, Token_Do },
+  [ 3] = { "const",    5, Token_Const },
+  [ 4] = { "break",    5, Token_Break },
+  [ 6] = { "register", 8, Token_Register },
+  [ 9] = { "union",    5, Token_Union },
+  [19] = { "default",  7, Token_Default },
+  [22] = { "if",       2, Token_If },
+  [24] = { "restrict", 8, Token_Restrict },
+  [25] = { "for",      3, Token_For },
+  [27] = { "case",     4, Token_Case },
+  [31] = { "continue", 8, Token_Continue },
+  [32] = { "return",   6, Token_Return },
+  [36] = { "struct",   6, Token_Struct },
+  [38] = { "sizeof",   6, Token_Sizeof },
+  [41] = { "volatile", 8, Token_Volatile },
+  [42] = { "extern",   6, Token_Extern },
+  [43] = { "static",   6, Token_Static },
+  [45] = { "goto",     4, Token_Goto },
+  [49] = { "inline",   6, Token_Inline },
+  [52] = { "while",    5, Token_While },
+  [53] = { "typedef",  7, Token_Typedef },
+  [55] = { "else",     4, Token_Else },
+  [56] = { "switch",   6, Token_Switch },
+  [60] = { "void",     4, Token_Void },
+  [63] = { "enum",     4, Token_Enum },
+};
+
 ///////////////
 // Lexer
-Token_Array load_all_tokens(Lexer* lexer, String8 file_path) {
-  MemoryZeroStruct(lexer);
- 
-  lexer->arena               = arena_init();
-  lexer->file                = file_load(lexer->arena, file_path);
-  lexer->current_character   = lexer->file.data.str;
-  lexer->file_start          = lexer->file.data.str;
-  lexer->file_end            = lexer->file.data.str + lexer->file.data.size;
-  lexer->line                = 1;
-  lexer->column              = 1;
-  lexer->current_token.type  = Token_Unknown;
-  lexer->current_token.value = Str8("");
+Token_Array load_all_tokens(Lexer* lexer, String8 file_path, Lexer_Flags flags) {
+  File_Map map = file_map_open(file_path);
+  Token_Array result = load_all_tokens_from_map(lexer, map, flags);
+  return result;
+}
+
+Token_Array load_all_tokens_from_map(Lexer* lexer, File_Map map, Lexer_Flags flags) {
+  Token_Array result = load_all_tokens_from_string(lexer, map.data, flags);
+  lexer->map       = map;
+  lexer->file.path = map.path;
+  return result;
+}
+
+Token_Array load_all_tokens_from_string(Lexer* lexer, String8 source, Lexer_Flags flags) {
+  lexer_init_at(lexer, source, flags, 0);
+  lexer->arena = line_index_arena_init(lexer->file.data.size);
+  lexer->lines = line_index_build(lexer->arena, lexer->file.data);
+
+  // NOTE(fz): Every token consumes at least one byte except Token_End_Of_File, so a file can never produce more than size + 1 tokens.
+  // Reserving that up front means the arena never has to move or grow, and the lexing loop needs no capacity check.
+  u64 max_tokens      = lexer->file.data.size + 1;
+  u64 tokens_reserve  = ARENA_HEADER_SIZE + (max_tokens + TOKEN_CHUNK_SIZE) * sizeof(Token);
+  lexer->tokens_arena = arena_init_sized(Max(tokens_reserve, ARENA_COMMIT_SIZE), ARENA_COMMIT_SIZE);
 
   Token_Array result = {0};
-  Token* list = ArenaPush(lexer->arena, Token, TOKEN_ARRAY_SIZE);
+  Token* list = ArenaPushNoZero(lexer->tokens_arena, Token, TOKEN_CHUNK_SIZE);
   u64 count   = 0;
+  b32 done    = false;
 
-  for (;;) {
-    Token token = next_token(lexer);
+  while (!done) {
+    for (u32 i = 0; i < TOKEN_CHUNK_SIZE; i += 1) {
+      Token token = next_token(lexer);
 #if PRINT_TOKENS
-    token_print(token);
+      token_print(lexer->file.data, token);
 #endif
-    list[count] = token;
-    count += 1;
-    if (token.type == Token_End_Of_File) {
-      break;
+      list[count] = token;
+      count += 1;
+      if (token.type == Token_End_Of_File) {
+        done = true;
+        break;
+      }
+    }
+
+    if (!done) {
+      Token* chunk = ArenaPushNoZero(lexer->tokens_arena, Token, TOKEN_CHUNK_SIZE);
+      Assert(chunk == list + count);
     }
   }
 
+  // Give back the unused tail of the last chunk
+  u64 capacity = AlignPow2(count, TOKEN_CHUNK_SIZE);
+  arena_pop(lexer->tokens_arena, (capacity - count) * sizeof(Token));
+
   result.tokens = list;
   result.count  = count;
+  result.source = lexer->file.data;
+  result.lines  = lexer->lines;
   return result;
 }
 
+void lexer_init_at(Lexer* lexer, String8 source, Lexer_Flags flags, u64 offset) {
+  MemoryZeroStruct(lexer);
+  lexer->flags              = flags;
+  lexer->file.data          = source;
+  lexer->file_start         = source.str;
+  lexer->file_end           = source.str + source.size;
+  lexer->current_character  = source.str + Min(offset, source.size);
+  lexer->current_token.type = Token_Unknown;
+}
+
+void lexer_free(Lexer* lexer) {
+  file_map_close(&lexer->map);
+  arena_free(lexer->tokens_arena);
+  arena_free(lexer->arena);
+  MemoryZeroStruct(lexer);
+}
+
 // Parse token
-// - Whitespace and Comments (skip/consume)
+// - One class lookup for the current byte, then one switch over the class
 // - Multi-character operators (longest match first)
 // - Keywords vs Identifiers
 // - Number literals
@@ -45,122 +196,102 @@ Token_Array load_all_tokens(Lexer* lexer, String8 file_path) {
 Token next_token(Lexer* lexer) {
   MemoryZeroStruct(&lexer->current_token);
 
-  char8 c = *(lexer->current_character);
   if (lexer_at_eof(lexer)) {
-    return make_token(lexer, Token_End_Of_File, 1);
-  } else if (char8_is_space(c)) {
-    return token_from_whitespace(lexer);
-  } else if (c == '#') {
-    return make_token(lexer, Token_Preprocessor_Hash, 1);  
-  } else if ((c == '/' && (peek_character(lexer, 1) == '/' || peek_character(lexer, 1) == '*')) || (c == '*' && peek_character(lexer, 1) == '/')) {
-    return token_from_comment(lexer);
-  } else if (char8_is_alpha(c) || c == '_') {
-    return token_from_identifier_or_keyword(lexer);
-  } else if (char8_is_digit(c)) {
-    return token_from_number(lexer);
-  } else if (c == '"') {
-    return token_from_string(lexer);
-  } else if (c == '\'') {
-    return token_from_character(lexer);
-  } else {
-    Token token;
-    token = token_from_operator(lexer);
-    if (token.type != Token_Unknown) {
-      return token;
-    }
-    token = token_from_delimiter(lexer);
-    if (token.type != Token_Unknown) {
-      return token;
-    }
-    token = token_from_braces(lexer);
-    if (token.type != Token_Unknown) {
-      return token;
-    }
-    return make_token(lexer, Token_Unknown, 1);
-  }
-}
-
-Token token_from_whitespace(Lexer* lexer) {
-  char8 c = *lexer->current_character;
-  
-  if (c == ' ') {
-    return make_token(lexer, Token_Space, 1);
+    return make_token(lexer, Token_End_Of_File, 0);
   }
 
-  if (c == '\t') {
-    return make_token(lexer, Token_Tab, 1);
+  char8 c = *(lexer->current_character);
+  switch (lexer_char_class[c]) {
+    case Char_Class_Whitespace: return token_from_whitespace(lexer);
+    case Char_Class_Identifier: return token_from_identifier_or_keyword(lexer);
+    case Char_Class_Digit:      return token_from_number(lexer);
+    case Char_Class_Quote:      return token_from_string(lexer);
+    case Char_Class_Apostrophe: return token_from_character(lexer);
+    case Char_Class_Operator:   return token_from_operator(lexer);
+    case Char_Class_Single:     return make_token(lexer, (Token_Type)lexer_single_token_type[c], 1);
+    case Char_Class_Slash: {
+      char8 next = peek_character(lexer, 1);
+      if (next == '/' || next == '*') {
+        return token_from_comment(lexer);
+      }
+      return token_from_operator(lexer);
+    }
   }
 
-  if (c == '\n') {
-    lexer->line  += 1;
-    lexer->column = 1;
-    return make_token(lexer, Token_New_Line, 1);
-  }
+  return make_token(lexer, Token_Unknown, 1);
+}
 
-  if (c == '\r') {
-    char8* start = lexer->current_character;
+Token token_from_whitespace(Lexer* lexer) {
+  char8* start = lexer->current_character;
+  char8 c      = *start;
+  b32 merge    = HasFlags(lexer->flags, Lexer_Flag_Merge_Whitespace);
 
+  if (c == ' ' || c == '\t') {
+    Token_Type type = (c == ' ') ? Token_Space : Token_Tab;
     u32 length = 1;
-    if (peek_character(lexer, 1) == '\n') {
-      length = 2;
+    if (merge) {
+      length = (u32)(scan_skip_byte(start, lexer->file_end, c) - start);
     }
+    Token token = make_token(lexer, type, length);
+    token.count = length;
+    return token;
+  }
+
+  if (c == '\n' || c == '\r') {
+    // NOTE(fz): \r\n is a single line break
+    char8* end = start;
+    u32 count  = 0;
+    do {
+      if (*end == '\r' && end + 1 < lexer->file_end && end[1] == '\n') {
+        end += 2;
+      } else {
+        end += 1;
+      }
+      count += 1;
+    } while (merge && end < lexer->file_end && (*end == '\n' || *end == '\r'));
 
-    lexer->line  += 1;
-    lexer->column = 1;
-    return make_token(lexer, Token_New_Line, length);
+    Token token = make_token(lexer, Token_New_Line, (u32)(end - start));
+    token.count = count;
+    return token;
   }
 
   return (Token){.type = Token_Unknown};
 }
 
-internal Token token_from_comment(Lexer* lexer) {
+Token token_from_comment(Lexer* lexer) {
   Token token = {0};
   char8* start = lexer->current_character;
+  char8* end   = start;
   char8 c = *start;
 
   if (c == '/' && peek_character(lexer, 1) == '/') {
     token.type = Token_Comment_Line;
-    token.start_offset = start - lexer->file_start;
-
-    advance(lexer); // consume first '/'
-    advance(lexer); // consume second '/'
-
-    while (!lexer_at_eof(lexer)) {
-      char8 ch = *(lexer->current_character);
-      if (ch == '\n' || ch == '\r') break;
-      advance(lexer);
-    }
-
-    token.end_offset = lexer->current_character - lexer->file_start;
+    end = scan_find_either(start + 2, lexer->file_end, '\n', '\r');
   }
 
   else if (c == '/' && peek_character(lexer, 1) == '*') {
     token.type = Token_Comment_Block;
-    token.start_offset = start - lexer->file_start;
+    end = lexer->file_end; // Unterminated block comments run to the end of the file
 
-    advance(lexer); // consume '/'
-    advance(lexer); // consume '*'
-
-    while (!lexer_at_eof(lexer)) {
-      if (*(lexer->current_character) == '*' && peek_character(lexer, 1) == '/') {
-        advance(lexer); // consume '*'
-        advance(lexer); // consume '/'
+    char8* star = scan_find_byte(start + 2, lexer->file_end, '*');
+    while (star + 1 < lexer->file_end) {
+      if (star[1] == '/') {
+        end = star + 2;
         break;
       }
-      advance(lexer);
+      star = scan_find_byte(star + 1, lexer->file_end, '*');
     }
-
-    token.end_offset = lexer->current_character - lexer->file_start;
   }
 
   else {
-    ERROR_MESSAGE_AND_EXIT("Expected comment token");
+    // NOTE(fz): Not a comment after all. A one byte Unknown token lets the parser report it instead of ending the run.
+    return make_token(lexer, Token_Unknown, 1);
   }
 
-  token.line   = lexer->line;
-  token.column = lexer->column;
-  token.value  = string8_range(lexer->file_start + token.start_offset,
-                               lexer->file_start + token.end_offset);
+  token.start_offset = offset_of_character(lexer, start);
+  token.length       = (u32)(end - start);
+  token.count        = 1;
+  lexer->current_character = end;
 
   return token;
 }
@@ -276,48 +407,6 @@ Token token_from_operator(Lexer* lexer) {
         return make_token(lexer, Token_Bit_Xor, 1);
       }
       
-    case '~':
-      return make_token(lexer, Token_Bit_Not, 1);
-  }
-  
-  return (Token){.type = Token_Unknown};
-}
-
-Token token_from_delimiter(Lexer* lexer) {
-  char8 c = *lexer->current_character;
-  
-  switch (c) {
-    case ';':
-      return make_token(lexer, Token_Semicolon, 1);
-    case ',':
-      return make_token(lexer, Token_Comma, 1);
-    case '.':
-      return make_token(lexer, Token_Dot, 1);
-    case ':':
-      return make_token(lexer, Token_Colon, 1);
-    case '?':
-      return make_token(lexer, Token_Question, 1);
-  }
-  
-  return (Token){.type = Token_Unknown};
-}
-
-Token token_from_braces(Lexer* lexer) {
-  char8 c = *lexer->current_character;
-  
-  switch (c) {
-    case '(':
-      return make_token(lexer, Token_Open_Parenthesis, 1);
-    case ')':
-      return make_token(lexer, Token_Close_Parenthesis, 1);
-    case '{':
-      return make_token(lexer, Token_Open_Brace, 1);
-    case '}':
-      return make_token(lexer, Token_Close_Brace, 1);
-    case '[':
-      return make_token(lexer, Token_Open_Bracket, 1);
-    case ']':
-      return make_token(lexer, Token_Close_Bracket, 1);
   }
   
   return (Token){.type = Token_Unknown};
@@ -328,15 +417,17 @@ Token token_from_identifier_or_keyword(Lexer* lexer) {
   char8 c = *start;
   u32 len = 0;
   
-  while (char8_is_alphanum(c) || c == '_') {
+  while (lexer_char_class[c] == Char_Class_Identifier || lexer_char_class[c] == Char_Class_Digit) {
     c = peek_character(lexer, len++);
   }
   len -= 1;
   
   Token token = make_token_range(lexer, Token_Identifier, start, start + len);
-  Token_Type keyword_type = is_token_keyword(token);
+  Token_Type keyword_type = is_token_keyword(string8_new(len, start));
   if (keyword_type != Token_Identifier) {
     token.type = keyword_type;
+  } else if (HasFlags(lexer->flags, Lexer_Flag_Intern)) {
+    token.id = intern_string8(string8_new(len, start));
   }
   
   return token;
@@ -409,27 +500,22 @@ Token token_from_number(Lexer* lexer) {
 
 
 Token token_from_string(Lexer* lexer) {
-  advance(lexer); // + 1 to skip opening quote
+  advance(lexer); // skip opening quote
   char8* start = lexer->current_character;
-  char8 c = *start;
-  u32 len = 0;
+  char8* end   = start;
 
-  c = peek_character(lexer, len + 1); // pre increment to skip open quote
-  
-  while (!lexer_at_eof(lexer) && c != '"') {
-    if (c == '\\') {
-      c = peek_character(lexer, len++);
-      if (!lexer_at_eof(lexer)) {
-        c = peek_character(lexer, len++);
-      }
-    } else {
-      c = peek_character(lexer, len++);
+  for (;;) {
+    end = scan_find_either(end, lexer->file_end, '"', '\\');
+    if (end >= lexer->file_end || *end == '"') {
+      break;
     }
+    end += 2; // skip '\' and the escaped character
   }
-  
-  len -= 1; // We don't want the closing quote
-  advance(lexer);
-  return make_token_range(lexer, Token_String_Literal, start, start + len);
+  end = Min(end, lexer->file_end);
+
+  Token token = make_token_range(lexer, Token_String_Literal, start, end); // We don't want the quotes
+  advance(lexer); // skip closing quote
+  return token;
 }
 
 Token token_from_character(Lexer* lexer) {
@@ -459,10 +545,9 @@ Token token_from_character(Lexer* lexer) {
 
 Token make_token_range(Lexer* lexer, Token_Type type, char8* start, char8* end) {
   lexer->current_token.type         = type;
-  lexer->current_token.value.str    = start;
-  lexer->current_token.value.size   = (u32)(end - start);
   lexer->current_token.start_offset = offset_of_character(lexer, start);
-  lexer->current_token.end_offset   = offset_of_character(lexer, end);
+  lexer->current_token.length       = (u32)(end - start);
+  lexer->current_token.count        = 1;
 
   advance_by(lexer, (u32)(end - start));
 
@@ -471,45 +556,25 @@ Token make_token_range(Lexer* lexer, Token_Type type, char8* start, char8* end)
 
 Token make_token(Lexer* lexer, Token_Type type, u32 length) {
   lexer->current_token.type         = type;
-  lexer->current_token.value.str    = lexer->current_character;
-  lexer->current_token.value.size   = length;
   lexer->current_token.start_offset = offset_of_character(lexer, lexer->current_character);
-  lexer->current_token.end_offset   = offset_of_character(lexer, lexer->current_character + length);
+  lexer->current_token.length       = length;
+  lexer->current_token.count        = 1;
 
   advance_by(lexer, length);
 
   return lexer->current_token;
 }
 
-Token_Type is_token_keyword(Token identifier_token) {
-  String8 value = identifier_token.value;
-  
-  if (string8_equal(value, Str8("return")))    return Token_Return;
-  if (string8_equal(value, Str8("if")))        return Token_If;
-  if (string8_equal(value, Str8("else")))      return Token_Else;
-  if (string8_equal(value, Str8("while")))     return Token_While;
-  if (string8_equal(value, Str8("for")))       return Token_For;
-  if (string8_equal(value, Str8("break")))     return Token_Break;
-  if (string8_equal(value, Str8("continue")))  return Token_Continue;
-  if (string8_equal(value, Str8("struct")))    return Token_Struct;
-  if (string8_equal(value, Str8("union")))     return Token_Union;
-  if (string8_equal(value, Str8("enum")))      return Token_Enum;
-  if (string8_equal(value, Str8("typedef")))   return Token_Typedef;
-  if (string8_equal(value, Str8("static")))    return Token_Static;
-  if (string8_equal(value, Str8("void")))      return Token_Void;
-  if (string8_equal(value, Str8("const")))     return Token_Const;
-  if (string8_equal(value, Str8("extern")))    return Token_Extern;
-  if (string8_equal(value, Str8("switch")))    return Token_Switch;
-  if (string8_equal(value, Str8("case")))      return Token_Case;
-  if (string8_equal(value, Str8("default")))   return Token_Default;
-  if (string8_equal(value, Str8("sizeof")))    return Token_Sizeof;
-  if (string8_equal(value, Str8("inline")))    return Token_Inline;
-  if (string8_equal(value, Str8("do")))        return Token_Do;
-  if (string8_equal(value, Str8("goto")))      return Token_Goto;
-  if (string8_equal(value, Str8("restrict")))  return Token_Restrict;
-  if (string8_equal(value, Str8("volatile")))  return Token_Volatile;
-  if (string8_equal(value, Str8("register")))  return Token_Register;
-    
+Token_Type is_token_keyword(String8 value) {
+  if (value.size < KEYWORD_MIN_SIZE || value.size > KEYWORD_MAX_SIZE) {
+    return Token_Identifier;
+  }
+
+  const Keyword* keyword = &keyword_table[KEYWORD_HASH(value.str[0], value.str[value.size-1], value.size)];
+  if (keyword->size == value.size && MemoryMatch(keyword->name, value.str, value.size)) {
+    return keyword->type;
+  }
+
   return Token_Identifier;
 }
 
@@ -530,21 +595,12 @@ char8 peek_character(Lexer* lexer, u32 offset) {
 
 void advance(Lexer* lexer) {
   if (lexer->current_character >= lexer->file_end)  return;
-    
-  if (*(lexer->current_character) == '\n') {
-    lexer->line += 1;
-    lexer->column = 1;
-  } else {
-    lexer->column += 1;
-  }
-    
   lexer->current_character += 1;
 }
 
 void advance_by(Lexer* lexer, u32 count) {
-  for (u32 i = 0; i < count && lexer->current_character < lexer->file_end; i += 1) {
-    advance(lexer);
-  }
+  u64 remaining = (u64)(lexer->file_end - lexer->current_character);
+  lexer->current_character += Min((u64)count, remaining);
 }
 
 b32 is_token_whitespace(Token token) {
@@ -554,7 +610,67 @@ b32 is_token_whitespace(Token token) {
   return result;
 }
 
-void token_print(Token token) {
+String8 token_value(String8 source, Token token) {
+  String8 result = string8_new(token.length, source.str + token.start_offset);
+  return result;
+}
+
+u32 token_end_offset(Token token) {
+  return token.start_offset + token.length;
+}
+
+u64 token_index_at(Token* tokens, u64 count, u32 offset) {
+  u64 low  = 0;
+  u64 high = count;
+  while (low < high) {
+    u64 middle = low + (high - low) / 2;
+    if (tokens[middle].start_offset < offset) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+Line_Index line_index_build(Arena* arena, String8 source) {
+  // NOTE(fz): Reserve the worst case (every byte a newline) and give the tail back once the real count is known.
+  Line_Index result = {0};
+  result.offsets = ArenaPushNoZero(arena, u32, source.size);
+  result.count   = scan_newlines(source, result.offsets);
+  arena_pop(arena, (source.size - result.count) * sizeof(u32));
+  return result;
+}
+
+Arena* line_index_arena_init(u64 source_size) {
+  // NOTE(fz): line_index_build briefly takes 4 bytes per source byte, a fixed reserve would cap the file size.
+  u64 reserve  = ARENA_HEADER_SIZE + source_size * sizeof(u32);
+  Arena* result = arena_init_sized(Max(reserve, ARENA_COMMIT_SIZE), ARENA_COMMIT_SIZE);
+  return result;
+}
+
+Text_Position text_position_from_offset(Line_Index* lines, u32 offset) {
+  // Number of newlines strictly before offset
+  u64 low  = 0;
+  u64 high = lines->count;
+  while (low < high) {
+    u64 middle = low + (high - low) / 2;
+    if (lines->offsets[middle] < offset) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  u32 line_start = (low == 0) ? 0 : lines->offsets[low - 1] + 1;
+  Text_Position result = {
+    .line   = (u32)low + 1,
+    .column = offset - line_start + 1,
+  };
+  return result;
+}
+
+void token_print(String8 source, Token token) {
   // Safety: check enum range
   if (token.type >= Token_Count) {
     printf("xx Token_Type out of range: %d\n", token.type);
@@ -567,19 +683,21 @@ void token_print(Token token) {
     printf(" ");
   }
 
-  Assert(token.start_offset + token.value.size == token.end_offset);
-
   // Print token value if it has one (non-empty string)
-  if (token.value.size > 0 && token.value.str) {
+  String8 value = token_value(source, token);
+  if (value.size > 0) {
     if (token.type == Token_New_Line) {
       printf("Token value: '\\n'");
+      if (token.count > 1) {
+        printf(" x%u", token.count);
+      }
     } else {
-      printf("Token value: '%.*s'", (s32)token.value.size, token.value.str);
+      printf("Token value: '%.*s'", (s32)value.size, value.str);
     }
-    for (u32 i = token.value.size; i < 16; i += 1) {
+    for (u32 i = value.size; i < 16; i += 1) {
       printf(" ");
     }
-    printf("StartEnd: [%d, %d]", token.start_offset, token.end_offset);
+    printf("StartEnd: [%d, %d]", token.start_offset, token_end_offset(token));
   }
   printf("\n");
 
@@ -216,49 +216,105 @@ typedef enum Token_Type {
   Token_Count, // Keep at the end of the enum
 } Token_Type;
 
+// DOC(fz): A token is only a range in the source. The value is token_value(), line and column are text_position_from_offset().
 typedef struct Token {
   Token_Type type;
-  String8 value;
   u32 start_offset;
-  u32 end_offset;
-  u32 line;
-  u32 column;
+  u32 length;
+  union {
+    u32 count;    /* Characters (Token_Space, Token_Tab) or line breaks (Token_New_Line) in a merged whitespace run, 1 otherwise */
+    Intern_Id id; /* Token_Identifier lexed with Lexer_Flag_Intern only, count stays 1 without it */
+  };
 } Token;
+StaticAssert(sizeof(Token) == 16, token_size_check);
+
+// DOC(fz): Sorted offsets of every line break in a file, a '\n' or a '\r' not followed by one (old Mac files). Built once per file, line and column are only resolved when a diagnostic asks for them.
+typedef struct Line_Index {
+  u32* offsets;
+  u64  count;
+} Line_Index;
+
+typedef struct Text_Position {
+  u32 line;   /* 1 based */
+  u32 column; /* 1 based */
+} Text_Position;
 
 typedef struct Token_Array {
   Token* tokens;
   u64 count;
+  String8    source; /* File contents the token offsets point into */
+  Line_Index lines;
 } Token_Array;
-#define TOKEN_ARRAY_SIZE 4096
+#define TOKEN_CHUNK_SIZE 4096 /* Tokens committed at a time. Chunks are contiguous, so Token_Array stays flat */
+
+///////////////
+// Character classes
+// DOC(fz): Every byte maps to exactly one class, next_token switches on the class of the current byte. Bytes with no
+// class, '\v', '\f' and everything >= 0x80 included, are Token_Unknown (see lexer_char_class).
+typedef enum Char_Class {
+  Char_Class_Unknown = 0,
+  Char_Class_Whitespace, // ' ', \t, \n, \r
+  Char_Class_Identifier, // a-z, A-Z, _
+  Char_Class_Digit,      // 0-9
+  Char_Class_Quote,      // "
+  Char_Class_Apostrophe, // '
+  Char_Class_Slash,      // / (comment or divide)
+  Char_Class_Operator,   // Operators that may continue into a two or three character operator
+  Char_Class_Single,     // Tokens that are always exactly one character
+
+  Char_Class_Count,
+} Char_Class;
+
+///////////////
+// Keywords
+typedef struct Keyword {
+  const char8* name;
+  u32 size;
+  Token_Type type;
+} Keyword;
+#define KEYWORD_TABLE_SIZE 64
+#define KEYWORD_MIN_SIZE   2
+#define KEYWORD_MAX_SIZE   8
+#define KEYWORD_HASH(first, last, size) ((((u32)(first))*14 + ((u32)(last))*41 + (u32)(size)) & (KEYWORD_TABLE_SIZE-1))
 
 ///////////////
 // Lexer
+typedef enum Lexer_Flags {
+  Lexer_Flag_None             = 0,
+  Lexer_Flag_Merge_Whitespace = 1 << 0, /* A run of spaces, tabs or line breaks becomes one token with a count */
+  Lexer_Flag_Intern           = 1 << 1, /* Every Token_Identifier gets its intern id. The parser and the rules need them */
+} Lexer_Flags;
+
 typedef struct Lexer {
   Arena* arena;
+  Lexer_Flags flags;
+  Arena* tokens_arena; /* Reserved up front for the worst case token count of the file */
 
-  File_Data file;
+  File_Map  map;  /* Tokens point into the mapping, it must outlive them. Empty when lexing from a string */
+  File_Data file; /* Same bytes as map.data, or the string being lexed */
   char8* file_start;
   char8* file_end;
   char8* current_character;
 
-  u32 line;
-  u32 column;
+  Line_Index lines;
 
   Token current_token;
 } Lexer;
 
 
-Token_Array load_all_tokens(Lexer* lexer, String8 file_path); /* Initializes the lexer with workspace path */
+Token_Array load_all_tokens(Lexer* lexer, String8 file_path, Lexer_Flags flags); /* Initializes the lexer with workspace path */
+Token_Array load_all_tokens_from_map(Lexer* lexer, File_Map map, Lexer_Flags flags); /* Same, over a file already mapped. The lexer takes ownership of the map */
+Token_Array load_all_tokens_from_string(Lexer* lexer, String8 source, Lexer_Flags flags); /* Same, over bytes the caller owns. They must outlive the tokens */
+void        lexer_init_at(Lexer* lexer, String8 source, Lexer_Flags flags, u64 offset); /* Points the lexer at offset without allocating, next_token lexes from there */
+void        lexer_free(Lexer* lexer); /* Unmaps the file and releases the lexer's arenas. Tokens are invalid afterwards */
 Token       next_token(Lexer* lexer);
 
-#define current_token(parser) (Token*)(&parser->tokens.tokens[parser->index])
+#define current_token(parser) ((Token*)(&(parser)->tokens.tokens[(parser)->index]))
 
 // Tokening
 Token token_from_whitespace(Lexer* lexer);
 Token token_from_comment(Lexer* lexer);
 Token token_from_operator(Lexer* lexer);
-Token token_from_delimiter(Lexer* lexer);
-Token token_from_braces(Lexer* lexer);
 Token token_from_identifier_or_keyword(Lexer* lexer);
 Token token_from_number(Lexer* lexer);
 Token token_from_string(Lexer* lexer);
@@ -267,7 +323,7 @@ Token token_from_preprocessor(Lexer* lexer);
 
 Token make_token_range(Lexer* lexer, Token_Type type, char8* start, char8* end);
 Token make_token(Lexer* lexer, Token_Type type, u32 length);
-Token_Type is_token_keyword(Token identifier_token); /* Checks if a token is an identifier token is a keyword */
+Token_Type is_token_keyword(String8 value); /* Returns the keyword type of value, or Token_Identifier if it is not a keyword */
 
 // Manouvering
 char8 peek_character(Lexer* lexer, u32 offset);            /* Returns next character without advancing */
@@ -277,7 +333,15 @@ b32   lexer_at_eof(Lexer* lexer);                          /* Checks if lexer is
 u32   offset_of_character(Lexer* lexer, char8* character); /* Returns the offset into the file, of the given character */
 b32   is_token_whitespace(Token token);
 
+// Token data
+String8       token_value(String8 source, Token token);                 /* Slice of source covered by token */
+u32           token_end_offset(Token token);                            /* One past the last byte of token */
+u64           token_index_at(Token* tokens, u64 count, u32 offset);     /* First token starting at or after offset, count if none */
+Line_Index    line_index_build(Arena* arena, String8 source);           /* Takes 4 bytes per source byte from arena until it returns */
+Arena*        line_index_arena_init(u64 source_size);                   /* Arena sized for line_index_build of a source of that size */
+Text_Position text_position_from_offset(Line_Index* lines, u32 offset); /* Line and column of offset, binary search over lines */
+
 // Help
-void token_print(Token token);
+void token_print(String8 source, Token token);
 
 #endif // LEXER_H
\ No newline at end of file
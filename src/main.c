@@ -1,6 +1,9 @@
 
 #define DEBUG 1
-#define PRINT_TOKENS 1
+#define PRINT_TOKENS 0 // NOTE(fz): Lexing runs on every worker, printing tokens interleaves output across files
+#define PRINT_AST 1
+#define BENCHMARK 0
+#define ANALYSIS_CACHE 1 // NOTE(fz): Keeps lexed and parsed files in .fz_cache/ at the project root, unchanged files skip straight to analysis
 #define FZ_ENABLE_ASSERT 1 
 #include "main.h"
 
@@ -8,28 +11,92 @@
 
 void entry_point(Command_Line command_line) {
   Arena* arena = arena_init();
+#if OS_WINDOWS && !FZ_HEADLESS
   win32_enable_console(true);
+#endif
+
+#if BENCHMARK
+  benchmark_run(arena);
+# if OS_WINDOWS
+  system("pause");
+# endif
+  return;
+#endif
   
   String8 pwd = path_get_working_directory();
   String8 dir = path_get_current_directory_name(pwd);
   if (string8_equal(dir, Str8("build"))) {
     pwd = path_dirname(pwd); // move back if in build
   }
+  String8 cache_directory = {0};
+#if ANALYSIS_CACHE
+  cache_directory = path_join(arena, pwd, Str8(".fz_cache"));
+#endif
   pwd = path_join(arena, pwd, Str8("dummy"));
-  String8_List files = file_get_all_file_paths_recursively(arena, pwd);
 
-  for (String8_Node* node = files.first; node != NULL; node = node->next) {
-    String8 path = node->value;
-    b32 is_dot_c = file_has_extension(path, Str8(".c"));
-    b32 is_dot_h = file_has_extension(path, Str8(".h"));
-    if (!is_dot_c && !is_dot_h) {
-      continue;
+  // NOTE(fz): -daemon keeps the tree resident and re-analyzes what changes, -query and -stop talk to it from another process.
+  // A -query with no daemon running falls back to the one shot run below.
+  // -lint only lexes and runs the token rules, -whitespace only reads bytes. Both are meant for pre-commit hooks.
+  b32 is_daemon     = false;
+  b32 is_query      = false;
+  b32 is_stop       = false;
+  b32 is_lint       = false;
+  b32 is_whitespace = false;
+  for (u32 i = 0; i < command_line.args_count; i += 1) {
+    Command_Line_Arg arg = command_line.args[i];
+    if (arg.is_flag) {
+      is_daemon     |= string8_equal(arg.key, Str8("daemon"));
+      is_query      |= string8_equal(arg.key, Str8("query"));
+      is_stop       |= string8_equal(arg.key, Str8("stop"));
+      is_lint       |= string8_equal(arg.key, Str8("lint"));
+      is_whitespace |= string8_equal(arg.key, Str8("whitespace"));
+    }
+  }
+
+  if (is_daemon) {
+    Daemon daemon;
+    if (daemon_start(&daemon, arena, pwd, 0)) {
+      printf("Watching "); string8_printf(daemon.root); printf(" as %.*s\n", (s32)daemon.name.size, daemon.name.str);
+      fflush(stdout);
+      daemon_run(&daemon);
+      daemon_stop(&daemon);
+    } else {
+      printf("A daemon is already watching "); string8_printf(pwd); printf("\n");
     }
+    return;
+  }
+  if (is_query || is_stop) {
+    String8 reply = {0};
+    if (daemon_request(arena, pwd, is_stop ? Str8("stop") : Str8("report"), &reply)) {
+      fwrite(reply.str, 1, reply.size, stdout);
+      return;
+    }
+    if (is_stop) {
+      printf("No daemon is watching "); string8_printf(pwd); printf("\n");
+      return;
+    }
+  }
+
+  if (is_lint || is_whitespace) {
+    Analysis analysis = analysis_run_tree(arena, pwd, 0, (String8){0}, is_lint ? Analysis_Mode_Lint : Analysis_Mode_Whitespace);
+    analysis_report(&analysis);
+    analysis_release(&analysis);
+    return;
+  }
+
+  Analysis analysis = analysis_run_tree(arena, pwd, 0, cache_directory, Analysis_Mode_Full);
+  analysis_report(&analysis);
+  if (is_query) {
+    analysis_release(&analysis);
+    return; // Same output as the daemon's, nothing else and no pause
+  }
 
-    u64 index = 0;
-    if (string8_find_last(path, Str8("\\"), &index) && index+1 <= path.size-1) {
-      String8 file_string8 = string8_slice(path, index+1, path.size);
+#if PRINT_AST
+  for (u64 i = 0; i < analysis.files_count; i += 1) {
+    String8 path = analysis.files[i].path;
 
+    String8 file_string8 = path_get_file_name(path);
+    if (file_string8.size > 0) {
       if (!string8_equal(file_string8, TEST_FILE)) {
         continue;
       }
@@ -43,20 +110,26 @@ void entry_point(Command_Line command_line) {
     }
 
     Lexer lexer;
-    Token_Array tokens = load_all_tokens(&lexer, path);
+    Token_Array tokens = load_all_tokens(&lexer, path, Lexer_Flag_Merge_Whitespace | Lexer_Flag_Intern);
     
     Parser parser;
 #if DEBUG
     parser.file = &lexer.file;
 #endif
 
-    AST_Node* ast = parse_ast(&parser, tokens);
+    parse_ast(&parser, tokens);
 
     printf("\n");
     print_ast(&parser, &lexer, true, true);
+    parser_free(&parser);
+    lexer_free(&lexer);
 
 	  printf("\n------------------\n");
   }
+#endif
+  analysis_release(&analysis); // Paths live in the worker arenas
 
+#if OS_WINDOWS
   system("pause");
+#endif
 }
\ No newline at end of file
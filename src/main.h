@@ -5,12 +5,30 @@
 #include "fz_include.h"
 
 // *.h
+#include "scan.h"
+#include "intern.h"
 #include "lexer.h"
 #include "parser.h"
+#include "cache.h"
+#include "document.h"
+#include "rules.h"
+#include "symbols.h"
+#include "analysis.h"
+#include "daemon.h"
+#include "benchmark.h"
 
 // *.c
+#include "scan.c"
+#include "intern.c"
 #include "lexer.c"
 #include "parser.c"
+#include "cache.c"
+#include "document.c"
+#include "rules.c"
+#include "symbols.c"
+#include "analysis.c"
+#include "daemon.c"
+#include "benchmark.c"
 
 
 
@@ -1,56 +1,103 @@
 
 ///////////////
 // Parser
-internal AST_Node* parse_ast(Parser* parser, Token_Array tokens) {
+internal AST* parse_ast(Parser* parser, Token_Array tokens) {
 #ifndef DEBUG
   MemoryZeroStruct(parser);
 #endif
 
-  parser->arena       = arena_init();
-  parser->nodes_arena = arena_init();
-  parser->root        = node_new(parser->nodes_arena, 0, 0, AST_Node_Program);
+  parser_init(parser, tokens, 0);
+  AST* ast = &parser->ast;
 
-  parser->tokens = tokens;
-  parser->index  = 0;
-
-  parser->errors       = ArenaPush(parser->arena, Parser_Error, PARSER_ERROR_CAPACITY);
-  parser->errors_cap   = PARSER_ERROR_CAPACITY;
-  parser->errors_count = 0;
+  Token* current = parser_skip_trivia(parser);
+  while (current->type != Token_End_Of_File) {
+    parse_top_level(parser);
+    current = current_token(parser);
+  }
+  return ast;
+}
 
-  Token* current = current_token(parser);
-  while (current != NULL && current->type != Token_End_Of_File) {
-    AST_Node* top_level_item = get_top_level_construct(parser);
-    if (top_level_item) {
-      node_add_child(parser->root, top_level_item);
-    } else if (is_token_trivia(*current)) {
-      node_add_child(parser->root, node_new(parser->nodes_arena, current->start_offset, current->end_offset, node_type_from_trivia_token(current->type)));
-    } else {
-      advance_token_skip_trivia(parser, parser->root); // Add top level trivia to tree
-    }
-    current = advance_token_skip_trivia(parser, parser->root);
+internal AST_Index parse_top_level(Parser* parser) {
+  AST* ast  = &parser->ast;
+  u64 index = parser->index;
+  AST_Index result = get_top_level_construct(parser);
+  if (result != AST_NULL) {
+    ast_add_child(ast, ast->root, result);
+  }
+  if (parser->index == index) {
+    // NOTE(fz): Nothing could start here and it was already reported, step over it so the loop always moves.
+    advance_token_skip_trivia(parser);
   }
-  return parser->root;
+  parser_recover(parser);
+  return result;
 }
 
-internal AST_Node* get_top_level_construct(Parser* parser) {
-  Token* token = peek_token(parser, 0);
+internal void parser_init(Parser* parser, Token_Array tokens, u64 reserve) {
+  parser->arena = parser_arena_init(reserve);
+  ast_init(&parser->ast, reserve);
+  parser->ast.tokens = &parser->tokens;
 
-  if (token->type == Token_Unknown || token->type == Token_End_Of_File) {
-    return NULL;
-  }
+  parser->tokens        = tokens;
+  parser->index         = 0;
+  parser->previous_end  = 0;
+  parser->previous_type = Token_Unknown;
+  parser->is_recovering = false;
 
-  // Empty declaration
-  if (token->type == Token_Semicolon) {
-    advance_token(parser);
-    return node_new(parser->nodes_arena, token->start_offset, token->end_offset, AST_Node_EmptyDecl);
-  }
-  
-  // Preprocessor
-  if (token->type == Token_Preprocessor_Hash) {
-    return parse_preprocessor(parser);
+  parser->errors          = ArenaPushNoZero(parser->arena, Parser_Error, PARSER_ERROR_CHUNK_SIZE);
+  parser->errors_capacity = PARSER_ERROR_CHUNK_SIZE;
+  parser->errors_count    = 0;
+  parser_strings_init(&parser->strings, reserve);
+
+  parser->typedef_names    = NULL;
+  parser->typedef_ids      = NULL;
+  parser->typedef_count    = 0;
+  parser->typedef_capacity = 0;
+  parser_typedef_grow(parser, PARSER_TYPEDEF_FIRST_BITS);
+}
+
+internal void parser_free(Parser* parser) {
+  parser_strings_free(&parser->strings);
+  ast_free(&parser->ast);
+  arena_free(parser->arena);
+  MemoryZeroStruct(parser);
+}
+
+internal Arena* parser_arena_init(u64 reserve) {
+  // NOTE(fz): A one shot parse frees its arenas right away. A Document keeps its parser for as long as the file is open,
+  // next to thousands of others, and reserves for the size of its file instead.
+  Arena* result = (reserve == 0) ? arena_init() : arena_init_resident(reserve);
+  return result;
+}
+
+internal AST_Index get_top_level_construct(Parser* parser) {
+  Token* token = current_token(parser);
+  AST_Index result = AST_NULL;
+
+  switch (token->type) {
+    case Token_End_Of_File: {
+    } break;
+
+    // Empty declaration
+    case Token_Semicolon: {
+      result = ast_node_new(&parser->ast, token->start_offset, token_end_offset(*token), AST_Node_EmptyDecl);
+      advance_token_skip_trivia(parser);
+    } break;
+
+    // Preprocessor
+    case Token_Preprocessor_Hash: {
+      result = parse_preprocessor(parser);
+    } break;
+
+    default: {
+      if (token->type == Token_Identifier && (token->id == InternNames[Intern_Name_Static_Assert] || token->id == InternNames[Intern_Name_Static_Assert_Macro])) {
+        result = parse_static_assert(parser);
+      } else {
+        result = parse_declaration(parser, true);
+      }
+    } break;
   }
 
-  return NULL;
+  return result;
 }
 
 internal Token* peek_token(Parser* parser, u64 offset) {
@@ -64,27 +111,35 @@ internal Token* peek_token(Parser* parser, u64 offset) {
 }
 
 internal Token* advance_token(Parser* parser) {
-  Token* result = NULL;
-  if (parser->index < parser->tokens.count) {
+  // NOTE(fz): The last token is always End_Of_File, advancing stops there instead of walking off the array.
+  if (parser->index + 1 < parser->tokens.count) {
     parser->index += 1;
-    result = current_token(parser);
   }
+  Token* result = current_token(parser);
   return result;
 }
 
-internal Token* advance_token_skip_trivia(Parser* parser, AST_Node* parent) {
-  Token* result = advance_token(parser);
-  while (is_token_trivia(*result)) {
-    node_add_child(parent, node_new(parser->nodes_arena, result->start_offset, result->end_offset, node_type_from_trivia_token(result->type)));
-    if (result->type == Token_End_Of_File) {
-      break;
-    }
-    advance_token(parser);
-    result = current_token(parser);
+internal Token* advance_token_skip_trivia(Parser* parser) {
+  Token* previous = current_token(parser);
+  if (!is_token_trivia(*previous)) {
+    parser->previous_end  = token_end_offset(*previous);
+    parser->previous_type = previous->type;
   }
+  advance_token(parser);
+  Token* result = parser_skip_trivia(parser);
   return result;
 }
 
+internal Token* peek_token_skip_trivia(Parser* parser, u64* offset) {
+  u64 last = parser->tokens.count - 1;
+  u64 i    = Min(parser->index + *offset, last);
+  while (i < last && is_token_trivia(parser->tokens.tokens[i])) {
+    i += 1;
+  }
+  *offset = i - parser->index;
+  return &parser->tokens.tokens[i];
+}
+
 internal b32 is_token_trivia(Token token) {
   b32 result = false;
   Token_Type type = token.type;
@@ -111,126 +166,1654 @@ internal AST_Node_Type node_type_from_trivia_token(Token_Type type) {
   return result;
 }
 
-internal Token* assert_token(Parser* parser, Token_Type type) {
-  Token* t = peek_token(parser, 0);
-  if (!t || t->type != type) {
-    ERROR_MESSAGE_AND_EXIT("Expected token %s but got %s.", ast_node_types[type], ast_node_types[t->type]);
-    exit(1);
-  }
-  return t;
+internal String8 parser_token_value(Parser* parser, Token* token) {
+  String8 result = token_value(parser->tokens.source, *token);
+  return result;
 }
 
 /*
-  Program:
-    - Declaration:
-      - < // not in tree
-      - [start]stdio
-      - .
-      - h[end]
-      - > // not in tree
+  #include <stdio.h>   -> Preprocessor_Include_System: stdio.h
+  #include "local.h"   -> Preprocessor_Include_Local:  local.h
+  #define PI 3.14      -> Preprocessor_Define:         PI 3.14
+  #pragma once         -> Preprocessor_Pragma:         once
+  #ifdef X, #endif ... -> Preprocessor_Directive:      ifdef X
 */
-internal AST_Node* parse_preprocessor(Parser* parser) {
+internal AST_Index parse_preprocessor(Parser* parser) {
   Token* hash_token = current_token(parser);
   Assert(hash_token->type == Token_Preprocessor_Hash);
 
-  AST_Node* result = NULL;
-  Token_Type preprocessor_type = Token_Unknown;
-  Token* preprocessor_token    = advance_token_skip_trivia(parser, parser->root);
-
-  if (0) {
-  } else if (string8_equal(preprocessor_token->value, Str8("include"))) {
-    Token* next = advance_token_skip_trivia(parser, parser->root);
-    if (next->type == Token_Less) {
-      Token* current = advance_token_skip_trivia(parser, parser->root);
-      u32 start = current->start_offset;
-      while (current->type != Token_Greater) {
-        current = advance_token_skip_trivia(parser, parser->root);
-        if (current->type == Token_End_Of_File) {
-          ERROR_MESSAGE_AND_EXIT("Unexpected end of file");
-        }
+  AST_Node_Type type = AST_Node_Preprocessor_Directive;
+  Token* directive   = advance_token_in_line(parser);
+  u32 start = directive->start_offset;
+  u32 end   = token_end_offset(*directive);
+
+  if (directive->type == Token_New_Line || directive->type == Token_End_Of_File) {
+    // Null directive, a lone '#'
+    start = hash_token->start_offset;
+    end   = token_end_offset(*hash_token);
+  } else {
+    // Directive names are identifiers, if, else and the like are keywords and have no id
+    Intern_Id name = (directive->type == Token_Identifier) ? directive->id : 0;
+    Token* next    = advance_token_in_line(parser);
+
+    if (name == InternNames[Intern_Name_Include]) {
+      if (next->type == Token_Less) {
+        type  = AST_Node_Preprocessor_Include_System;
+        start = token_end_offset(*next);
+        end   = start;
+      } else if (next->type == Token_String_Literal) {
+        type  = AST_Node_Preprocessor_Include_Local;
+        start = next->start_offset;
+        end   = token_end_offset(*next);
+      } else {
+        parser_emit_error(parser, Parser_Error_Expected_Include_Path, next->start_offset, token_end_offset(*next));
       }
-      // NOTE(fz): current->end_offset - 1 to skip '>'
-      result = node_new(parser->nodes_arena, start, current->end_offset - 1, AST_Node_Preprocessor_Include_System);
-      advance_token(parser); // skip- Token_Greater
-    } else if (next->type == Token_String_Literal) {
-      result = node_new(parser->nodes_arena, preprocessor_token->start_offset, preprocessor_token->end_offset, AST_Node_Preprocessor_Include_Local);
-    } else {
-      ERROR_MESSAGE_AND_EXIT("Unhandled preprocessor: %s", token_type_names[next->type]);
+    } else if (name == InternNames[Intern_Name_Define]) {
+      type  = AST_Node_Preprocessor_Define;
+      start = next->start_offset;
+    } else if (name == InternNames[Intern_Name_Pragma]) {
+      type  = AST_Node_Preprocessor_Pragma;
+      start = next->start_offset;
+    }
+
+    // NOTE(fz): The rest of the line belongs to the directive, whatever it is. It is not C, so it isn't parsed.
+    b32 is_include = (type == AST_Node_Preprocessor_Include_System || type == AST_Node_Preprocessor_Include_Local);
+    b32 is_closed  = (type != AST_Node_Preprocessor_Include_System);
+    Token* token   = next;
+    while (token->type != Token_New_Line && token->type != Token_End_Of_File) {
+      if (!is_closed && token->type == Token_Greater) {
+        end       = token->start_offset;
+        is_closed = true;
+      } else if (!is_include) {
+        // Literal offsets leave the quotes out, the line text keeps the closing one
+        b32 is_literal = (token->type == Token_String_Literal || token->type == Token_Char_Literal);
+        end = token_end_offset(*token) + (is_literal ? 1 : 0);
+      }
+      token = advance_token_in_line(parser);
     }
-  } else if (string8_equal(preprocessor_token->value, Str8("define"))) {
   }
 
+  AST_Index result = ast_node_new(&parser->ast, start, Max(start, end), type);
+
+  // NOTE(fz): The newline ending a directive is a synchronization point, same as a ';'.
+  parser->previous_type = Token_New_Line;
+  parser_skip_trivia(parser);
+  return result;
+}
+
+internal Token* advance_token_in_line(Parser* parser) {
+  Token* result = current_token(parser);
+  if (result->type == Token_New_Line || result->type == Token_End_Of_File) {
+    return result;
+  }
+  if (!is_token_trivia(*result)) {
+    parser->previous_end  = token_end_offset(*result);
+    parser->previous_type = result->type;
+  }
+
+  result = advance_token(parser);
+  for (;;) {
+    if (result->type == Token_Space || result->type == Token_Tab || result->type == Token_Comment_Line || result->type == Token_Comment_Block) {
+      ast_trivia_push(&parser->ast, (u32)parser->index);
+      result = advance_token(parser);
+    } else if (result->type == Token_Unknown && peek_token(parser, 1)->type == Token_New_Line && string8_equal(parser_token_value(parser, result), Str8("\\"))) {
+      // Line continuation, the directive goes on past this newline
+      advance_token(parser);
+      ast_trivia_push(&parser->ast, (u32)parser->index);
+      result = advance_token(parser);
+    } else {
+      break;
+    }
+  }
   return result;
 }
 
-internal void parser_emit_error(Parser* parser, u32 start_offset, u32 end_offset, String8 message) {
-  if (parser->errors_count >= parser->errors_cap) {
+internal void parser_emit_error(Parser* parser, Parser_Error_Code code, u32 start_offset, u32 end_offset) {
+  parser_emit_error_arguments(parser, code, start_offset, end_offset, (String8){0}, (String8){0});
+}
+
+internal void parser_emit_error_arguments(Parser* parser, Parser_Error_Code code, u32 start_offset, u32 end_offset, String8 first, String8 second) {
+  // NOTE(fz): Until the parser synchronizes, anything else wrong is most likely fallout of this error.
+  if (parser->is_recovering) {
     return;
   }
+  parser->is_recovering = true;
+
+  if (parser->errors_count == parser->errors_capacity) {
+    Parser_Error* chunk = ArenaPushNoZero(parser->arena, Parser_Error, PARSER_ERROR_CHUNK_SIZE);
+    Assert(chunk == parser->errors + parser->errors_capacity);
+    parser->errors_capacity += PARSER_ERROR_CHUNK_SIZE;
+  }
 
-  Parser_Error* error = &parser->errors[parser->errors_count++];
-  error->message      = string8_copy(parser->arena, message);
+  Parser_Error* error = &parser->errors[parser->errors_count];
+  error->code         = code;
   error->start_offset = start_offset;
   error->end_offset   = end_offset;
+  error->arguments[0] = parser_strings_intern(&parser->strings, first);
+  error->arguments[1] = parser_strings_intern(&parser->strings, second);
+  parser->errors_count += 1;
+}
+
+internal void parser_emit_error_expected(Parser* parser, Token_Type expected, Token* got) {
+  String8 first  = string8_from_cstring((char8*)token_type_names[expected]);
+  String8 second = string8_from_cstring((char8*)token_type_names[got->type]);
+  parser_emit_error_arguments(parser, Parser_Error_Expected_Token, got->start_offset, token_end_offset(*got), first, second);
+}
+
+internal String8 parser_error_format(Arena* arena, Parser_Error_Code code, String8* arguments) {
+  Assert(code < Parser_Error_Code_Count);
+  String8 format = string8_from_cstring((char8*)parser_error_formats[code]);
+  String8 result = string8_format(arena, format, (s32)arguments[0].size, arguments[0].str, (s32)arguments[1].size, arguments[1].str);
+  return result;
+}
+
+///////////////
+// Error strings
+internal void parser_strings_init(Parser_Strings* table, u64 reserve) {
+  MemoryZeroStruct(table);
+  table->arena    = parser_arena_init(reserve);
+  table->strings  = ArenaPushNoZero(table->arena, String8, PARSER_STRINGS_CHUNK_SIZE);
+  table->capacity = PARSER_STRINGS_CHUNK_SIZE;
+  table->strings[0] = (String8){0};
+  table->count      = 1;
+
+  table->slots_arena = parser_arena_init(reserve);
+  table->slots_count = PARSER_STRINGS_CHUNK_SIZE * 2;
+  table->slots       = ArenaPush(table->slots_arena, u32, table->slots_count);
+}
+
+internal void parser_strings_free(Parser_Strings* table) {
+  arena_free(table->slots_arena);
+  arena_free(table->arena);
+  MemoryZeroStruct(table);
+}
+
+internal u32 parser_strings_intern(Parser_Strings* table, String8 value) {
+  if (value.size == 0) {
+    return 0;
+  }
+
+  u32 mask = table->slots_count - 1;
+  u32 slot = parser_string_hash(value) & mask;
+  while (table->slots[slot] != 0) {
+    if (string8_equal(table->strings[table->slots[slot]], value)) {
+      return table->slots[slot];
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  if (table->count == table->capacity) {
+    String8* chunk = ArenaPushNoZero(table->arena, String8, PARSER_STRINGS_CHUNK_SIZE);
+    Assert(chunk == table->strings + table->capacity);
+    table->capacity += PARSER_STRINGS_CHUNK_SIZE;
+  }
+  u32 result = table->count;
+  table->strings[result] = string8_copy(table->slots_arena, value);
+  table->count += 1;
+  table->slots[slot] = result;
+
+  // NOTE(fz): Kept at most half full so probing stays short. The old slots stay in the arena, they are small.
+  if (table->count * 2 > table->slots_count) {
+    table->slots_count *= 2;
+    table->slots = ArenaPush(table->slots_arena, u32, table->slots_count);
+    mask = table->slots_count - 1;
+    for (u32 id = 1; id < table->count; id += 1) {
+      u32 at = parser_string_hash(table->strings[id]) & mask;
+      while (table->slots[at] != 0) {
+        at = (at + 1) & mask;
+      }
+      table->slots[at] = id;
+    }
+  }
+  return result;
+}
+
+internal void parser_recover(Parser* parser) {
+  if (!parser->is_recovering) {
+    return;
+  }
+
+  // NOTE(fz): A construct that ended on its own ';' or '}' is already synchronized, skipping would eat the next one.
+  Token_Type previous = parser->previous_type;
+  if (previous != Token_Semicolon && previous != Token_Close_Brace && previous != Token_New_Line) {
+    parser_synchronize(parser);
+  }
+  parser->is_recovering = false;
+}
+
+internal void parser_synchronize(Parser* parser) {
+  Token* token = current_token(parser);
+  while (token->type != Token_End_Of_File) {
+    if (token->type == Token_Semicolon) {
+      advance_token_skip_trivia(parser);
+      break;
+    }
+    if (token->type == Token_Close_Brace) {
+      break; // Left for the block or record it closes
+    }
+    if (token->type == Token_Preprocessor_Hash && parser_is_line_start(parser, parser->index)) {
+      break;
+    }
+    token = advance_token_skip_trivia(parser);
+  }
+}
+
+internal b32 parser_is_line_start(Parser* parser, u64 index) {
+  b32 result = true;
+  while (index > 0) {
+    Token_Type type = parser->tokens.tokens[index - 1].type;
+    if (type == Token_New_Line) {
+      break;
+    }
+    if (type != Token_Space && type != Token_Tab && type != Token_Comment_Block) {
+      result = false;
+      break;
+    }
+    index -= 1;
+  }
+  return result;
+}
+
+internal Token* parser_skip_trivia(Parser* parser) {
+  Token* result = current_token(parser);
+  while (is_token_trivia(*result) && result->type != Token_End_Of_File) {
+    ast_trivia_push(&parser->ast, (u32)parser->index);
+    result = advance_token(parser);
+  }
+  return result;
+}
+
+internal b32 parser_expect(Parser* parser, Token_Type type) {
+  Token* token = current_token(parser);
+  b32 result = (token->type == type);
+  if (result) {
+    advance_token_skip_trivia(parser);
+  } else {
+    parser_emit_error_expected(parser, type, token);
+  }
+  return result;
+}
+
+internal b32 parser_is_type_name(Parser* parser, Token* token) {
+  b32 result = false;
+  switch (token->type) {
+    case Token_Void:
+    case Token_Const:
+    case Token_Volatile:
+    case Token_Restrict:
+    case Token_Struct:
+    case Token_Union:
+    case Token_Enum: {
+      result = true;
+    } break;
+
+    case Token_Identifier: {
+      result = (intern_flags(token->id) & (Intern_Flag_Builtin_Type | Intern_Flag_Builtin_Specifier)) != 0 ||
+               parser_typedef_exists(parser, token->id);
+    } break;
+  }
+  return result;
+}
+
+internal b32 parser_is_cast(Parser* parser) {
+  Assert(current_token(parser)->type == Token_Open_Parenthesis);
+  b32 result = false;
+
+  u64 offset   = 1;
+  Token* token = peek_token_skip_trivia(parser, &offset);
+  if (parser_is_type_name(parser, token)) {
+    result = true;
+  } else if (token->type == Token_Identifier) {
+    // NOTE(fz): Without a symbol table an unknown name is only a type when nothing else parses:
+    // (T*) is never an expression, and neither is (T) directly followed by an operand.
+    // (T) - x, (T) * x and (T)(x) stay expressions.
+    offset += 1;
+    Token* next = peek_token_skip_trivia(parser, &offset);
+    if (next->type == Token_Multiply) {
+      while (next->type == Token_Multiply || next->type == Token_Const) {
+        offset += 1;
+        next = peek_token_skip_trivia(parser, &offset);
+      }
+      result = (next->type == Token_Close_Parenthesis);
+    } else if (next->type == Token_Close_Parenthesis) {
+      offset += 1;
+      Token* after = peek_token_skip_trivia(parser, &offset);
+      switch (after->type) {
+        case Token_Identifier:
+        case Token_Int_Literal:
+        case Token_Hex_Literal:
+        case Token_Float_Literal:
+        case Token_Char_Literal:
+        case Token_String_Literal:
+        case Token_Sizeof:
+        case Token_Not:
+        case Token_Bit_Not: {
+          result = true;
+        } break;
+      }
+    }
+  }
+  return result;
+}
+
+///////////////
+// Expressions
+global const u8 expression_infix_precedence[Token_Count] = {
+  [Token_Comma]              = Precedence_Comma,
+  [Token_Assign]             = Precedence_Assignment,
+  [Token_Plus_Assign]        = Precedence_Assignment,
+  [Token_Minus_Assign]       = Precedence_Assignment,
+  [Token_Multiply_Assign]    = Precedence_Assignment,
+  [Token_Divide_Assign]      = Precedence_Assignment,
+  [Token_Modulo_Assign]      = Precedence_Assignment,
+  [Token_Left_Shift_Assign]  = Precedence_Assignment,
+  [Token_Right_Shift_Assign] = Precedence_Assignment,
+  [Token_Bit_And_Assign]     = Precedence_Assignment,
+  [Token_Bit_Or_Assign]      = Precedence_Assignment,
+  [Token_Bit_Xor_Assign]     = Precedence_Assignment,
+  [Token_Question]           = Precedence_Conditional,
+  [Token_Logical_Or]         = Precedence_Logical_Or,
+  [Token_Logical_And]        = Precedence_Logical_And,
+  [Token_Bit_Or]             = Precedence_Bit_Or,
+  [Token_Bit_Xor]            = Precedence_Bit_Xor,
+  [Token_Bit_And]            = Precedence_Bit_And,
+  [Token_Equal]              = Precedence_Equality,
+  [Token_Not_Equal]          = Precedence_Equality,
+  [Token_Less]               = Precedence_Relational,
+  [Token_Less_Equal]         = Precedence_Relational,
+  [Token_Greater]            = Precedence_Relational,
+  [Token_Greater_Equal]      = Precedence_Relational,
+  [Token_Left_Shift]         = Precedence_Shift,
+  [Token_Right_Shift]        = Precedence_Shift,
+  [Token_Plus]               = Precedence_Additive,
+  [Token_Minus]              = Precedence_Additive,
+  [Token_Multiply]           = Precedence_Multiplicative,
+  [Token_Divide]             = Precedence_Multiplicative,
+  [Token_Modulo]             = Precedence_Multiplicative,
+  [Token_Open_Parenthesis]   = Precedence_Postfix,
+  [Token_Open_Bracket]       = Precedence_Postfix,
+  [Token_Dot]                = Precedence_Postfix,
+  [Token_Arrow]              = Precedence_Postfix,
+  [Token_Increment]          = Precedence_Postfix,
+  [Token_Decrement]          = Precedence_Postfix,
+};
+
+global const u8 expression_infix_node[Token_Count] = {
+  [Token_Comma]              = AST_Node_Comma,
+  [Token_Assign]             = AST_Node_Assign,
+  [Token_Plus_Assign]        = AST_Node_Add_Assign,
+  [Token_Minus_Assign]       = AST_Node_Sub_Assign,
+  [Token_Multiply_Assign]    = AST_Node_Mul_Assign,
+  [Token_Divide_Assign]      = AST_Node_Div_Assign,
+  [Token_Modulo_Assign]      = AST_Node_Mod_Assign,
+  [Token_Left_Shift_Assign]  = AST_Node_Left_Shift_Assign,
+  [Token_Right_Shift_Assign] = AST_Node_Right_Shift_Assign,
+  [Token_Bit_And_Assign]     = AST_Node_Bit_And_Assign,
+  [Token_Bit_Or_Assign]      = AST_Node_Bit_Or_Assign,
+  [Token_Bit_Xor_Assign]     = AST_Node_Bit_Xor_Assign,
+  [Token_Question]           = AST_Node_Conditional,
+  [Token_Logical_Or]         = AST_Node_Logical_Or,
+  [Token_Logical_And]        = AST_Node_Logical_And,
+  [Token_Bit_Or]             = AST_Node_Bit_Or,
+  [Token_Bit_Xor]            = AST_Node_Bit_Xor,
+  [Token_Bit_And]            = AST_Node_Bit_And,
+  [Token_Equal]              = AST_Node_Equal,
+  [Token_Not_Equal]          = AST_Node_Not_Equal,
+  [Token_Less]               = AST_Node_Less,
+  [Token_Less_Equal]         = AST_Node_Less_Equal,
+  [Token_Greater]            = AST_Node_Greater,
+  [Token_Greater_Equal]      = AST_Node_Greater_Equal,
+  [Token_Left_Shift]         = AST_Node_Left_Shift,
+  [Token_Right_Shift]        = AST_Node_Right_Shift,
+  [Token_Plus]               = AST_Node_Add,
+  [Token_Minus]              = AST_Node_Sub,
+  [Token_Multiply]           = AST_Node_Mul,
+  [Token_Divide]             = AST_Node_Div,
+  [Token_Modulo]             = AST_Node_Mod,
+  [Token_Open_Parenthesis]   = AST_Node_Call,
+  [Token_Open_Bracket]       = AST_Node_Subscript,
+  [Token_Dot]                = AST_Node_Member,
+  [Token_Arrow]              = AST_Node_Pointer_Member,
+  [Token_Increment]          = AST_Node_Post_Inc,
+  [Token_Decrement]          = AST_Node_Post_Dec,
+};
+
+global const u8 expression_prefix_node[Token_Count] = {
+  [Token_Plus]      = AST_Node_Unary_Plus,
+  [Token_Minus]     = AST_Node_Unary_Minus,
+  [Token_Increment] = AST_Node_Pre_Inc,
+  [Token_Decrement] = AST_Node_Pre_Dec,
+  [Token_Multiply]  = AST_Node_Deref,
+  [Token_Bit_And]   = AST_Node_Address,
+  [Token_Not]       = AST_Node_Not,
+  [Token_Bit_Not]   = AST_Node_Bit_Not,
+};
+
+internal AST_Index parse_expression(Parser* parser) {
+  AST_Index result = parse_expression_with_precedence(parser, Precedence_Comma);
+  return result;
+}
+
+internal AST_Index parse_expression_with_precedence(Parser* parser, Expression_Precedence min) {
+  AST* ast = &parser->ast;
+  u32 start = current_token(parser)->start_offset;
+  AST_Index left = parse_expression_prefix(parser);
+
+  for (;;) {
+    Token* op = current_token(parser);
+    Expression_Precedence precedence = (Expression_Precedence)expression_infix_precedence[op->type];
+    if (precedence == Precedence_None || precedence < min) {
+      break;
+    }
+
+    if (precedence == Precedence_Postfix) {
+      left = parse_expression_postfix(parser, left, start);
+      continue;
+    }
+
+    AST_Node_Type type = (AST_Node_Type)expression_infix_node[op->type];
+    advance_token_skip_trivia(parser);
+
+    AST_Index node = AST_NULL;
+    if (precedence == Precedence_Conditional) {
+      // a ? b : c, the middle is a full expression and the else branch is right associative
+      AST_Index then_branch = parse_expression_with_precedence(parser, Precedence_Comma);
+      parser_expect(parser, Token_Colon);
+      AST_Index else_branch = parse_expression_with_precedence(parser, Precedence_Conditional);
+      node = ast_node_new(ast, start, parser->previous_end, type);
+      ast_add_child(ast, node, left);
+      ast_make_binary(ast, node, then_branch, else_branch);
+    } else {
+      Expression_Precedence next = (precedence == Precedence_Assignment) ? precedence : (Expression_Precedence)(precedence + 1);
+      AST_Index right = parse_expression_with_precedence(parser, next);
+      node = ast_node_new(ast, start, parser->previous_end, type);
+      ast_make_binary(ast, node, left, right);
+    }
+    left = node;
+  }
+
+  return left;
+}
+
+internal AST_Index parse_expression_prefix(Parser* parser) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+  AST_Index result = AST_NULL;
+
+  switch (token->type) {
+    case Token_Identifier: {
+      // NOTE(fz): L"", u8"" and L'' prefixes are identifiers to the lexer, literal offsets leave out the opening quote.
+      Token* next = peek_token(parser, 1);
+      if ((next->type == Token_String_Literal || next->type == Token_Char_Literal) && next->start_offset == token_end_offset(*token) + 1) {
+        AST_Node_Type type = (next->type == Token_String_Literal) ? AST_Node_Literal_String : AST_Node_Literal_Char;
+        u32 end = token_end_offset(*next);
+        advance_token(parser);
+        next = advance_token_skip_trivia(parser);
+        while (type == AST_Node_Literal_String && next->type == Token_String_Literal) {
+          end  = token_end_offset(*next);
+          next = advance_token_skip_trivia(parser);
+        }
+        result = ast_node_new(ast, token->start_offset, end, type);
+      } else {
+        result = ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Identifier);
+        advance_token_skip_trivia(parser);
+      }
+    } break;
+
+    case Token_Int_Literal:
+    case Token_Hex_Literal: {
+      result = ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Literal_Int);
+      advance_token_skip_trivia(parser);
+    } break;
+
+    case Token_Float_Literal: {
+      result = ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Literal_Float);
+      advance_token_skip_trivia(parser);
+    } break;
+
+    case Token_Char_Literal: {
+      result = ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Literal_Char);
+      advance_token_skip_trivia(parser);
+    } break;
+
+    case Token_String_Literal: {
+      // Adjacent string literals are one literal
+      u32 end     = token_end_offset(*token);
+      Token* next = advance_token_skip_trivia(parser);
+      while (next->type == Token_String_Literal) {
+        end  = token_end_offset(*next);
+        next = advance_token_skip_trivia(parser);
+      }
+      result = ast_node_new(ast, token->start_offset, end, AST_Node_Literal_String);
+    } break;
+
+    case Token_Open_Parenthesis: {
+      if (parser_is_cast(parser)) {
+        advance_token_skip_trivia(parser);
+        AST_Index type = parse_type_name(parser);
+        parser_expect(parser, Token_Close_Parenthesis);
+        if (current_token(parser)->type == Token_Open_Brace) {
+          // (T){ ... }
+          AST_Index list = parse_initializer_list(parser);
+          result = ast_node_new(ast, token->start_offset, parser->previous_end, AST_Node_Compound_Literal);
+          ast_make_binary(ast, result, type, list);
+        } else {
+          AST_Index operand = parse_expression_with_precedence(parser, Precedence_Unary);
+          result = ast_node_new(ast, token->start_offset, parser->previous_end, AST_Node_Cast);
+          ast_make_binary(ast, result, type, operand);
+        }
+      } else {
+        // NOTE(fz): Grouping only decides shape, the parentheses themselves don't get a node.
+        advance_token_skip_trivia(parser);
+        result = parse_expression(parser);
+        parser_expect(parser, Token_Close_Parenthesis);
+      }
+    } break;
+
+    case Token_Sizeof: {
+      AST_Index operand = AST_NULL;
+      Token* next = advance_token_skip_trivia(parser);
+      if (next->type == Token_Open_Parenthesis && parser_is_cast(parser)) {
+        advance_token_skip_trivia(parser);
+        operand = parse_type_name(parser);
+        parser_expect(parser, Token_Close_Parenthesis);
+      } else {
+        operand = parse_expression_with_precedence(parser, Precedence_Unary);
+      }
+      result = ast_node_new(ast, token->start_offset, parser->previous_end, AST_Node_Sizeof);
+      ast_add_child(ast, result, operand);
+    } break;
+
+    default: {
+      AST_Node_Type type = (AST_Node_Type)expression_prefix_node[token->type];
+      if (type != AST_Node_Unknown) {
+        advance_token_skip_trivia(parser);
+        AST_Index operand = parse_expression_with_precedence(parser, Precedence_Unary);
+        result = ast_node_new(ast, token->start_offset, parser->previous_end, type);
+        ast_add_child(ast, result, operand);
+      } else {
+        parser_emit_error(parser, Parser_Error_Expected_Expression, token->start_offset, token_end_offset(*token));
+        result = ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Unknown);
+
+        // NOTE(fz): Closers and terminators are left for the caller to match, anything else is skipped so parsing moves on.
+        switch (token->type) {
+          case Token_Semicolon:
+          case Token_Comma:
+          case Token_Colon:
+          case Token_Close_Parenthesis:
+          case Token_Close_Bracket:
+          case Token_Close_Brace:
+          case Token_End_Of_File: {
+          } break;
+          default: {
+            advance_token_skip_trivia(parser);
+          } break;
+        }
+      }
+    } break;
+  }
+
+  return result;
+}
+
+internal AST_Index parse_expression_postfix(Parser* parser, AST_Index left, u32 start) {
+  AST* ast = &parser->ast;
+  Token* op = current_token(parser);
+  AST_Node_Type type = (AST_Node_Type)expression_infix_node[op->type];
+  AST_Index result = AST_NULL;
+
+  switch (op->type) {
+    case Token_Open_Parenthesis: {
+      result = ast_node_new(ast, start, 0, type);
+      ast_add_child(ast, result, left);
+
+      // Arguments bind tighter than the comma operator
+      Token* token = advance_token_skip_trivia(parser);
+      while (token->type != Token_Close_Parenthesis && token->type != Token_End_Of_File) {
+        ast_add_child(ast, result, parse_expression_with_precedence(parser, Precedence_Assignment));
+        token = current_token(parser);
+        if (token->type != Token_Comma) {
+          break;
+        }
+        token = advance_token_skip_trivia(parser);
+      }
+      parser_expect(parser, Token_Close_Parenthesis);
+      ASTNode(ast, result)->end_offset = parser->previous_end;
+    } break;
+
+    case Token_Open_Bracket: {
+      result = ast_node_new(ast, start, 0, type);
+      ast_add_child(ast, result, left);
+      advance_token_skip_trivia(parser);
+      ast_add_child(ast, result, parse_expression(parser));
+      parser_expect(parser, Token_Close_Bracket);
+      ASTNode(ast, result)->end_offset = parser->previous_end;
+    } break;
+
+    case Token_Dot:
+    case Token_Arrow: {
+      Token* member = advance_token_skip_trivia(parser);
+      AST_Index right = AST_NULL;
+      if (member->type == Token_Identifier) {
+        right = ast_node_new(ast, member->start_offset, token_end_offset(*member), AST_Node_Identifier);
+        advance_token_skip_trivia(parser);
+      } else {
+        parser_emit_error(parser, Parser_Error_Expected_Member_Name, member->start_offset, token_end_offset(*member));
+        right = ast_node_new(ast, member->start_offset, token_end_offset(*member), AST_Node_Unknown);
+      }
+      result = ast_node_new(ast, start, parser->previous_end, type);
+      ast_make_binary(ast, result, left, right);
+    } break;
+
+    case Token_Increment:
+    case Token_Decrement: {
+      result = ast_node_new(ast, start, token_end_offset(*op), type);
+      ast_add_child(ast, result, left);
+      advance_token_skip_trivia(parser);
+    } break;
+
+    default: {
+      Assert(!"Not a postfix operator");
+    } break;
+  }
+
+  return result;
+}
+
+internal AST_Index parse_type_name(Parser* parser) {
+  Token* token = current_token(parser);
+  u32 start = token->start_offset;
+  u32 end   = start;
+  u32 depth = 0;
+
+  while (token->type != Token_End_Of_File && token->type != Token_Semicolon) {
+    if (token->type == Token_Open_Parenthesis) {
+      depth += 1;
+    } else if (token->type == Token_Close_Parenthesis) {
+      if (depth == 0) {
+        break;
+      }
+      depth -= 1;
+    }
+    end   = token_end_offset(*token);
+    token = advance_token_skip_trivia(parser);
+  }
+
+  AST_Index result = ast_node_new(&parser->ast, start, end, AST_Node_Data_Type);
+  return result;
+}
+
+///////////////
+// Declarations
+internal AST_Index parse_declaration(Parser* parser, b32 allow_function) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+
+  switch (token->type) {
+    case Token_Identifier:
+    case Token_Multiply:
+    case Token_Open_Parenthesis:
+    case Token_Typedef:
+    case Token_Static:
+    case Token_Extern:
+    case Token_Register:
+    case Token_Inline:
+    case Token_Const:
+    case Token_Volatile:
+    case Token_Restrict:
+    case Token_Void:
+    case Token_Struct:
+    case Token_Union:
+    case Token_Enum: {
+    } break;
+
+    default: {
+      parser_emit_error(parser, Parser_Error_Expected_Declaration, token->start_offset, token_end_offset(*token));
+      return AST_NULL;
+    } break;
+  }
+
+  AST_Index result = ast_node_new(ast, token->start_offset, 0, AST_Node_Declaration);
+  b32 is_typedef   = false;
+  b32 is_function  = false;
+
+  AST_Index type = parse_declaration_specifiers(parser, &is_typedef);
+  if (type != AST_NULL) {
+    ast_add_child(ast, result, type);
+  }
+
+  // NOTE(fz): struct S { ... }; declares no names, the specifiers are the whole declaration.
+  token = current_token(parser);
+  for (u32 count = 0; token->type != Token_Semicolon; count += 1) {
+    AST_Index declarator = parse_declarator(parser, false);
+    if (declarator == AST_NULL) {
+      break;
+    }
+    ast_add_child(ast, result, declarator);
+    token = current_token(parser);
+
+    // Only the first declarator can have a body
+    if (allow_function && !is_typedef && count == 0 && token->type == Token_Open_Brace) {
+      ast_add_child(ast, result, parse_block(parser));
+      is_function = true;
+      break;
+    }
+
+    if (token->type == Token_Colon) {
+      AST_Index bit_field = ast_node_new(ast, token->start_offset, 0, AST_Node_Bit_Field);
+      advance_token_skip_trivia(parser);
+      ast_add_child(ast, bit_field, parse_expression_with_precedence(parser, Precedence_Conditional));
+      ASTNode(ast, bit_field)->end_offset = parser->previous_end;
+      ast_add_child(ast, declarator, bit_field);
+      token = current_token(parser);
+    }
+
+    if (token->type == Token_Assign) {
+      token = advance_token_skip_trivia(parser);
+      AST_Index initializer = ast_node_new(ast, token->start_offset, 0, AST_Node_Initializer);
+      ast_add_child(ast, initializer, parse_initializer(parser));
+      ASTNode(ast, initializer)->end_offset = parser->previous_end;
+      ast_add_child(ast, declarator, initializer);
+      token = current_token(parser);
+    }
+    ASTNode(ast, declarator)->end_offset = parser->previous_end;
+
+    if (is_typedef) {
+      parser_typedef_add(parser, declarator_name(ast, declarator));
+    }
+
+    if (token->type != Token_Comma) {
+      break;
+    }
+    token = advance_token_skip_trivia(parser);
+  }
+
+  if (is_function) {
+    ASTNode(ast, result)->type = AST_Node_Function;
+  } else {
+    parser_expect(parser, Token_Semicolon);
+    if (is_typedef) {
+      ASTNode(ast, result)->type = AST_Node_Typedef;
+    }
+  }
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
+}
+
+internal AST_Index parse_declaration_specifiers(Parser* parser, b32* is_typedef) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+  AST_Index result = AST_NULL;
+  b32 has_type = false; // A name after the type is the declarator, long long and unsigned int are the exception
+
+  for (;;) {
+    b32 is_specifier = true;
+    b32 is_record    = false;
+
+    switch (token->type) {
+      case Token_Typedef: {
+        *is_typedef = true;
+      } break;
+
+      case Token_Static:
+      case Token_Extern:
+      case Token_Register:
+      case Token_Inline:
+      case Token_Const:
+      case Token_Volatile:
+      case Token_Restrict: {
+      } break;
+
+      case Token_Void: {
+        has_type = true;
+      } break;
+
+      case Token_Struct:
+      case Token_Union:
+      case Token_Enum: {
+        has_type  = true;
+        is_record = true;
+      } break;
+
+      case Token_Identifier: {
+        Intern_Flags flags = intern_flags(token->id);
+        if (HasFlags(flags, Intern_Flag_Builtin_Specifier)) {
+        } else if (HasFlags(flags, Intern_Flag_Builtin_Type)) {
+          has_type = true;
+        } else if (!has_type && parser_typedef_exists(parser, token->id)) {
+          has_type = true;
+        } else if (!has_type) {
+          // NOTE(fz): Types from headers are unknown names. One is a type when what follows can only be a declarator:
+          // T x, T* x, T const x, T (*x). Anything else (x;  x = 1,  x[2]) makes it the declarator itself.
+          // Qualifier macros from headers are unknown names too. One is followed by the type, a known one (C_LINKAGE void)
+          // or another unknown name that a declarator follows (C_LINKAGE String8 s, C_LINKAGE T* p), and is no type itself.
+          u64 offset  = 1;
+          Token* next = peek_token_skip_trivia(parser, &offset);
+          b32 is_qualifier = false;
+          if (next->type == Token_Open_Parenthesis) {
+            offset += 1;
+            next = peek_token_skip_trivia(parser, &offset);
+            is_specifier = (next->type == Token_Multiply);
+          } else if (next->type == Token_Identifier && !parser_is_type_name(parser, next)) {
+            offset += 1;
+            Token* after = peek_token_skip_trivia(parser, &offset);
+            is_specifier = true;
+            is_qualifier = (after->type == Token_Identifier || after->type == Token_Multiply || parser_is_type_name(parser, after));
+          } else {
+            b32 is_cv    = (next->type == Token_Const || next->type == Token_Volatile || next->type == Token_Restrict);
+            is_qualifier = (parser_is_type_name(parser, next) && !is_cv) ||
+                           next->type == Token_Static || next->type == Token_Extern || next->type == Token_Inline;
+            is_specifier = is_qualifier || is_cv || next->type == Token_Identifier || next->type == Token_Multiply;
+          }
+          has_type = is_specifier && !is_qualifier;
+        } else {
+          is_specifier = false;
+        }
+      } break;
+
+      default: {
+        is_specifier = false;
+      } break;
+    }
+
+    if (!is_specifier) {
+      break;
+    }
+    if (result == AST_NULL) {
+      result = ast_node_new(ast, token->start_offset, 0, AST_Node_Data_Type);
+    }
+    if (is_record) {
+      ast_add_child(ast, result, parse_record(parser));
+      token = current_token(parser);
+    } else {
+      token = advance_token_skip_trivia(parser);
+    }
+  }
+
+  if (result != AST_NULL) {
+    ASTNode(ast, result)->end_offset = parser->previous_end;
+  }
+  return result;
+}
+
+internal AST_Index parse_declarator(Parser* parser, b32 is_abstract) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+
+  switch (token->type) {
+    case Token_Identifier:
+    case Token_Multiply:
+    case Token_Open_Parenthesis:
+    case Token_Open_Bracket: {
+    } break;
+
+    default: {
+      if (!is_abstract) {
+        parser_emit_error(parser, Parser_Error_Expected_Declarator, token->start_offset, token_end_offset(*token));
+      }
+      return AST_NULL;
+    } break;
+  }
+
+  AST_Index result = ast_node_new(ast, token->start_offset, 0, AST_Node_Declarator);
+
+  // Pointers and their qualifiers
+  for (;;) {
+    if (token->type == Token_Multiply || token->type == Token_Const || token->type == Token_Volatile || token->type == Token_Restrict ||
+        (token->type == Token_Identifier && token->id == InternNames[Intern_Name_Atomic])) {
+      token = advance_token_skip_trivia(parser);
+    } else {
+      break;
+    }
+  }
+
+  if (token->type == Token_Identifier) {
+    ast_add_child(ast, result, ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Identifier));
+    advance_token_skip_trivia(parser);
+  } else if (token->type == Token_Open_Parenthesis && parser_is_nested_declarator(parser)) {
+    // int (*name)(...), the parentheses only group
+    advance_token_skip_trivia(parser);
+    AST_Index nested = parse_declarator(parser, is_abstract);
+    if (nested != AST_NULL) {
+      ast_add_child(ast, result, nested);
+    }
+    parser_expect(parser, Token_Close_Parenthesis);
+  } else if (!is_abstract) {
+    parser_emit_error(parser, Parser_Error_Expected_Declarator_Name, token->start_offset, token_end_offset(*token));
+  }
+
+  // Suffixes, applied in source order
+  for (;;) {
+    token = current_token(parser);
+    if (token->type == Token_Open_Bracket) {
+      AST_Index dimension = ast_node_new(ast, token->start_offset, 0, AST_Node_Array_Dimension);
+      token = advance_token_skip_trivia(parser);
+      if (token->type != Token_Close_Bracket) {
+        ast_add_child(ast, dimension, parse_expression_with_precedence(parser, Precedence_Assignment));
+      }
+      parser_expect(parser, Token_Close_Bracket);
+      ASTNode(ast, dimension)->end_offset = parser->previous_end;
+      ast_add_child(ast, result, dimension);
+    } else if (token->type == Token_Open_Parenthesis) {
+      ast_add_child(ast, result, parse_parameter_list(parser));
+    } else {
+      break;
+    }
+  }
+
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
+}
+
+internal AST_Index parse_parameter_list(Parser* parser) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+  Assert(token->type == Token_Open_Parenthesis);
+
+  AST_Index result = ast_node_new(ast, token->start_offset, 0, AST_Node_Parameter_List);
+  token = advance_token_skip_trivia(parser);
+
+  while (token->type != Token_Close_Parenthesis && token->type != Token_End_Of_File) {
+    u64 index = parser->index;
+
+    if (token->type == Token_Dot) {
+      // ... is three Dot tokens
+      u32 start = token->start_offset;
+      for (u32 i = 0; i < 3 && token->type == Token_Dot; i += 1) {
+        token = advance_token_skip_trivia(parser);
+      }
+      ast_add_child(ast, result, ast_node_new(ast, start, parser->previous_end, AST_Node_Variadic));
+    } else {
+      AST_Index parameter = ast_node_new(ast, token->start_offset, 0, AST_Node_Parameter);
+      b32 is_typedef = false;
+      AST_Index type = parse_declaration_specifiers(parser, &is_typedef);
+      if (type != AST_NULL) {
+        ast_add_child(ast, parameter, type);
+      }
+      AST_Index declarator = parse_declarator(parser, true);
+      if (declarator != AST_NULL) {
+        ast_add_child(ast, parameter, declarator);
+      }
+      ASTNode(ast, parameter)->end_offset = parser->previous_end;
+      ast_add_child(ast, result, parameter);
+    }
+
+    token = current_token(parser);
+    if (parser->index == index) {
+      parser_emit_error(parser, Parser_Error_Expected_Parameter, token->start_offset, token_end_offset(*token));
+      break;
+    }
+    if (token->type != Token_Comma) {
+      break;
+    }
+    token = advance_token_skip_trivia(parser);
+  }
+
+  parser_expect(parser, Token_Close_Parenthesis);
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
+}
+
+internal AST_Index parse_record(Parser* parser) {
+  AST* ast = &parser->ast;
+  Token* keyword = current_token(parser);
+
+  AST_Node_Type type = AST_Node_Enum;
+  if (keyword->type == Token_Struct) {
+    type = AST_Node_Struct;
+  } else if (keyword->type == Token_Union) {
+    type = AST_Node_Union;
+  }
+  AST_Index result = ast_node_new(ast, keyword->start_offset, 0, type);
+
+  b32 has_tag  = false;
+  Token* token = advance_token_skip_trivia(parser);
+  if (token->type == Token_Identifier) {
+    ast_add_child(ast, result, ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Identifier));
+    token   = advance_token_skip_trivia(parser);
+    has_tag = true;
+  }
+
+  if (token->type == Token_Open_Brace) {
+    token = advance_token_skip_trivia(parser);
+
+    if (type == AST_Node_Enum) {
+      while (token->type == Token_Identifier) {
+        AST_Index enumerator = ast_node_new(ast, token->start_offset, 0, AST_Node_Enumerator);
+        ast_add_child(ast, enumerator, ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Identifier));
+        token = advance_token_skip_trivia(parser);
+        if (token->type == Token_Assign) {
+          advance_token_skip_trivia(parser);
+          ast_add_child(ast, enumerator, parse_expression_with_precedence(parser, Precedence_Conditional));
+          token = current_token(parser);
+        }
+        ASTNode(ast, enumerator)->end_offset = parser->previous_end;
+        ast_add_child(ast, result, enumerator);
+
+        if (token->type != Token_Comma) {
+          break;
+        }
+        token = advance_token_skip_trivia(parser);
+      }
+    } else {
+      while (token->type != Token_Close_Brace && token->type != Token_End_Of_File) {
+        u64 index = parser->index;
+        AST_Index member = (token->type == Token_Preprocessor_Hash) ? parse_preprocessor(parser) : parse_declaration(parser, false);
+        if (member != AST_NULL) {
+          ast_add_child(ast, result, member);
+        }
+        if (parser->index == index) {
+          advance_token_skip_trivia(parser);
+        }
+        parser_recover(parser);
+        token = current_token(parser);
+      }
+    }
+
+    parser_expect(parser, Token_Close_Brace);
+  } else if (!has_tag) {
+    parser_emit_error(parser, Parser_Error_Expected_Name_Or_Body, token->start_offset, token_end_offset(*token));
+  }
+
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
+}
+
+internal AST_Index parse_initializer(Parser* parser) {
+  AST_Index result = AST_NULL;
+  if (current_token(parser)->type == Token_Open_Brace) {
+    result = parse_initializer_list(parser);
+  } else {
+    result = parse_expression_with_precedence(parser, Precedence_Assignment);
+  }
+  return result;
+}
+
+/*
+  { 1, [2] = 3, .x.y = 4 }
+    Initializer_List
+      Literal_Int 1
+      Designation
+        Designator [2] -> Literal_Int 2
+        Literal_Int 3
+      Designation
+        Designator .x  -> Identifier x
+        Designator .y  -> Identifier y
+        Literal_Int 4
+*/
+internal AST_Index parse_initializer_list(Parser* parser) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+  Assert(token->type == Token_Open_Brace);
+
+  AST_Index result = ast_node_new(ast, token->start_offset, 0, AST_Node_Initializer_List);
+  token = advance_token_skip_trivia(parser);
+
+  while (token->type != Token_Close_Brace && token->type != Token_End_Of_File) {
+    AST_Index element = AST_NULL;
+
+    if (token->type == Token_Dot || token->type == Token_Open_Bracket) {
+      element = ast_node_new(ast, token->start_offset, 0, AST_Node_Designation);
+      while (token->type == Token_Dot || token->type == Token_Open_Bracket) {
+        AST_Index designator = ast_node_new(ast, token->start_offset, 0, AST_Node_Designator);
+        if (token->type == Token_Dot) {
+          Token* name = advance_token_skip_trivia(parser);
+          if (name->type == Token_Identifier) {
+            ast_add_child(ast, designator, ast_node_new(ast, name->start_offset, token_end_offset(*name), AST_Node_Identifier));
+            advance_token_skip_trivia(parser);
+          } else {
+            parser_emit_error(parser, Parser_Error_Expected_Member_Name, name->start_offset, token_end_offset(*name));
+          }
+        } else {
+          advance_token_skip_trivia(parser);
+          ast_add_child(ast, designator, parse_expression_with_precedence(parser, Precedence_Conditional));
+          parser_expect(parser, Token_Close_Bracket);
+        }
+        ASTNode(ast, designator)->end_offset = parser->previous_end;
+        ast_add_child(ast, element, designator);
+        token = current_token(parser);
+      }
+      parser_expect(parser, Token_Assign);
+      ast_add_child(ast, element, parse_initializer(parser));
+      ASTNode(ast, element)->end_offset = parser->previous_end;
+    } else {
+      element = parse_initializer(parser);
+    }
+    ast_add_child(ast, result, element);
+
+    token = current_token(parser);
+    if (token->type != Token_Comma) {
+      break;
+    }
+    token = advance_token_skip_trivia(parser);
+  }
+
+  parser_expect(parser, Token_Close_Brace);
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
+}
+
+internal AST_Index parse_static_assert(Parser* parser) {
+  AST* ast = &parser->ast;
+  Token* keyword = current_token(parser);
+  AST_Index result = ast_node_new(ast, keyword->start_offset, 0, AST_Node_Static_Assert);
+
+  advance_token_skip_trivia(parser);
+  parser_expect(parser, Token_Open_Parenthesis);
+  ast_add_child(ast, result, parse_expression_with_precedence(parser, Precedence_Assignment));
+  if (current_token(parser)->type == Token_Comma) {
+    advance_token_skip_trivia(parser);
+    ast_add_child(ast, result, parse_expression_with_precedence(parser, Precedence_Assignment));
+  }
+  parser_expect(parser, Token_Close_Parenthesis);
+  parser_expect(parser, Token_Semicolon);
+
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
+}
+
+internal b32 parser_is_declaration_start(Parser* parser) {
+  Token* token = current_token(parser);
+  b32 result = false;
+
+  switch (token->type) {
+    case Token_Typedef:
+    case Token_Static:
+    case Token_Extern:
+    case Token_Register:
+    case Token_Inline:
+    case Token_Const:
+    case Token_Volatile:
+    case Token_Restrict:
+    case Token_Void:
+    case Token_Struct:
+    case Token_Union:
+    case Token_Enum: {
+      result = true;
+    } break;
+
+    case Token_Identifier: {
+      if (parser_is_type_name(parser, token)) {
+        result = true;
+      } else {
+        // NOTE(fz): Unknown names, same guess as parse_declaration_specifiers. T x; is a declaration and so is T* x;
+        // when a declarator ending follows. a * b; is a declaration too, as an expression it would do nothing.
+        u64 offset  = 1;
+        Token* next = peek_token_skip_trivia(parser, &offset);
+        if (next->type == Token_Identifier) {
+          result = true;
+        } else if (next->type == Token_Multiply) {
+          while (next->type == Token_Multiply || next->type == Token_Const) {
+            offset += 1;
+            next = peek_token_skip_trivia(parser, &offset);
+          }
+          if (next->type == Token_Identifier) {
+            offset += 1;
+            next = peek_token_skip_trivia(parser, &offset);
+            result = (next->type == Token_Semicolon || next->type == Token_Assign || next->type == Token_Comma || next->type == Token_Open_Bracket);
+          }
+        }
+      }
+    } break;
+  }
+  return result;
+}
+
+internal b32 parser_is_nested_declarator(Parser* parser) {
+  Assert(current_token(parser)->type == Token_Open_Parenthesis);
+  u64 offset  = 1;
+  Token* next = peek_token_skip_trivia(parser, &offset);
+
+  b32 result = false;
+  switch (next->type) {
+    case Token_Multiply:
+    case Token_Open_Parenthesis:
+    case Token_Open_Bracket: {
+      result = true;
+    } break;
+
+    case Token_Identifier: {
+      result = !parser_is_type_name(parser, next);
+    } break;
+  }
+  return result;
+}
+
+internal AST_Index declarator_name(AST* ast, AST_Index declarator) {
+  AST_Index result = AST_NULL;
+  ASTForEachChild(ast, declarator, child) {
+    AST_Node_Type type = ASTNode(ast, child)->type;
+    if (type == AST_Node_Identifier) {
+      result = child;
+    } else if (type == AST_Node_Declarator) {
+      result = declarator_name(ast, child);
+    }
+    if (result != AST_NULL) {
+      break;
+    }
+  }
+  return result;
+}
+
+///////////////
+// Typedef names
+internal u32 parser_string_hash(String8 name) {
+  // FNV-1a
+  u32 result = 2166136261u;
+  for (u64 i = 0; i < name.size; i += 1) {
+    result ^= (u8)name.str[i];
+    result *= 16777619u;
+  }
+  return result;
+}
+
+internal u32 parser_id_slot(Intern_Id id, u32 bits) {
+  // Fibonacci hashing, ids of one shard are consecutive above the low bits
+  u32 result = (id * 2654435761u) >> (32 - bits);
+  return result;
+}
+
+internal void parser_typedef_add(Parser* parser, AST_Index name) {
+  if (name == AST_NULL) {
+    return;
+  }
+
+  // Adding is rare next to looking up, so the name is interned again rather than its token searched for
+  AST_Node* node = ASTNode(&parser->ast, name);
+  Intern_Id id   = intern_string8(string8_slice(parser->tokens.source, node->start_offset, node->end_offset));
+  if (parser_typedef_exists(parser, id)) {
+    return;
+  }
+
+  // NOTE(fz): Kept at most half full so probing stays short.
+  if ((parser->typedef_count + 1) * 2 > parser->typedef_capacity) {
+    parser_typedef_grow(parser, parser->typedef_capacity ? parser->typedef_bits + 1 : PARSER_TYPEDEF_FIRST_BITS);
+  }
+  u32 mask = parser->typedef_capacity - 1;
+  u32 slot = parser_id_slot(id, parser->typedef_bits);
+  while (parser->typedef_names[slot] != AST_NULL) {
+    slot = (slot + 1) & mask;
+  }
+  parser->typedef_names[slot] = name;
+  parser->typedef_ids[slot]   = id;
+  parser->typedef_count += 1;
+}
+
+internal b32 parser_typedef_exists(Parser* parser, Intern_Id id) {
+  b32 result = false;
+  if (parser->typedef_count == 0) {
+    return result;
+  }
+
+  u32 mask = parser->typedef_capacity - 1;
+  u32 slot = parser_id_slot(id, parser->typedef_bits);
+  while (parser->typedef_names[slot] != AST_NULL && !result) {
+    result = (parser->typedef_ids[slot] == id);
+    slot   = (slot + 1) & mask;
+  }
+  return result;
+}
+
+internal void parser_typedef_grow(Parser* parser, u32 bits) {
+  u32 capacity     = 1u << bits;
+  AST_Index* names = ArenaPush(parser->strings.slots_arena, AST_Index, capacity);
+  Intern_Id* ids   = ArenaPush(parser->strings.slots_arena, Intern_Id, capacity);
+  for (u32 i = 0; i < parser->typedef_capacity; i += 1) {
+    if (parser->typedef_names[i] == AST_NULL) {
+      continue;
+    }
+    u32 slot = parser_id_slot(parser->typedef_ids[i], bits);
+    while (names[slot] != AST_NULL) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    names[slot] = parser->typedef_names[i];
+    ids[slot]   = parser->typedef_ids[i];
+  }
+  parser->typedef_names    = names;
+  parser->typedef_ids      = ids;
+  parser->typedef_capacity = capacity;
+  parser->typedef_bits     = bits;
+}
+
+///////////////
+// Statements
+internal AST_Index parse_statement(Parser* parser) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+  AST_Index result = AST_NULL;
+
+  switch (token->type) {
+    case Token_Open_Brace: {
+      result = parse_block(parser);
+    } break;
+
+    case Token_Semicolon: {
+      result = ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Empty_Statement);
+      advance_token_skip_trivia(parser);
+    } break;
+
+    case Token_Preprocessor_Hash: {
+      result = parse_preprocessor(parser);
+    } break;
+
+    case Token_If: {
+      result = ast_node_new(ast, token->start_offset, 0, AST_Node_If);
+      advance_token_skip_trivia(parser);
+      ast_add_child(ast, result, parse_condition(parser));
+      ast_add_child(ast, result, parse_statement(parser));
+      if (current_token(parser)->type == Token_Else) {
+        advance_token_skip_trivia(parser);
+        ast_add_child(ast, result, parse_statement(parser));
+      }
+    } break;
+
+    case Token_While:
+    case Token_Switch: {
+      result = ast_node_new(ast, token->start_offset, 0, (token->type == Token_While) ? AST_Node_While : AST_Node_Switch);
+      advance_token_skip_trivia(parser);
+      ast_add_child(ast, result, parse_condition(parser));
+      ast_add_child(ast, result, parse_statement(parser));
+    } break;
+
+    case Token_Do: {
+      result = ast_node_new(ast, token->start_offset, 0, AST_Node_Do_While);
+      advance_token_skip_trivia(parser);
+      ast_add_child(ast, result, parse_statement(parser));
+      parser_expect(parser, Token_While);
+      ast_add_child(ast, result, parse_condition(parser));
+      parser_expect(parser, Token_Semicolon);
+    } break;
+
+    case Token_For: {
+      result = ast_node_new(ast, token->start_offset, 0, AST_Node_For);
+      advance_token_skip_trivia(parser);
+      parser_expect(parser, Token_Open_Parenthesis);
+
+      // Init, a declaration or an expression statement, either one eats the ';'
+      token = current_token(parser);
+      if (token->type == Token_Semicolon) {
+        ast_add_child(ast, result, ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Empty_Statement));
+        advance_token_skip_trivia(parser);
+      } else if (parser_is_declaration_start(parser)) {
+        ast_add_child(ast, result, parse_declaration(parser, false));
+      } else {
+        AST_Index init = ast_node_new(ast, token->start_offset, 0, AST_Node_Expression_Statement);
+        ast_add_child(ast, init, parse_expression(parser));
+        parser_expect(parser, Token_Semicolon);
+        ASTNode(ast, init)->end_offset = parser->previous_end;
+        ast_add_child(ast, result, init);
+      }
+
+      // Condition
+      token = current_token(parser);
+      if (token->type == Token_Semicolon) {
+        ast_add_child(ast, result, ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Empty_Statement));
+      } else {
+        ast_add_child(ast, result, parse_expression(parser));
+      }
+      parser_expect(parser, Token_Semicolon);
+
+      // Step
+      token = current_token(parser);
+      if (token->type == Token_Close_Parenthesis) {
+        ast_add_child(ast, result, ast_node_new(ast, token->start_offset, token->start_offset, AST_Node_Empty_Statement));
+      } else {
+        ast_add_child(ast, result, parse_expression(parser));
+      }
+      parser_expect(parser, Token_Close_Parenthesis);
+
+      ast_add_child(ast, result, parse_statement(parser));
+    } break;
+
+    case Token_Case:
+    case Token_Default: {
+      result = ast_node_new(ast, token->start_offset, 0, (token->type == Token_Case) ? AST_Node_Case : AST_Node_Default);
+      advance_token_skip_trivia(parser);
+      if (token->type == Token_Case) {
+        ast_add_child(ast, result, parse_expression_with_precedence(parser, Precedence_Conditional));
+      }
+      parser_expect(parser, Token_Colon);
+      if (current_token(parser)->type != Token_Close_Brace) {
+        ast_add_child(ast, result, parse_statement(parser));
+      }
+    } break;
+
+    case Token_Break: {
+      result = parse_jump_statement(parser, AST_Node_Break);
+    } break;
+
+    case Token_Continue: {
+      result = parse_jump_statement(parser, AST_Node_Continue);
+    } break;
+
+    case Token_Return: {
+      result = parse_jump_statement(parser, AST_Node_Return);
+    } break;
+
+    case Token_Goto: {
+      result = parse_jump_statement(parser, AST_Node_Goto);
+    } break;
+
+    default: {
+      u64 offset  = 1;
+      Token* next = peek_token_skip_trivia(parser, &offset);
+
+      if (token->type == Token_Identifier && next->type == Token_Colon) {
+        // label: statement
+        result = ast_node_new(ast, token->start_offset, 0, AST_Node_Label);
+        ast_add_child(ast, result, ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Identifier));
+        advance_token_skip_trivia(parser);
+        advance_token_skip_trivia(parser);
+        if (current_token(parser)->type != Token_Close_Brace) {
+          ast_add_child(ast, result, parse_statement(parser));
+        }
+      } else if (parser_is_declaration_start(parser)) {
+        // NOTE(fz): Function definitions are allowed here too, nested functions are a GCC extension seen in the wild.
+        result = parse_declaration(parser, true);
+      } else {
+        result = ast_node_new(ast, token->start_offset, 0, AST_Node_Expression_Statement);
+        ast_add_child(ast, result, parse_expression(parser));
+        parser_expect(parser, Token_Semicolon);
+      }
+    } break;
+  }
+
+  if (result != AST_NULL) {
+    ASTNode(ast, result)->end_offset = parser->previous_end;
+  }
+  return result;
+}
+
+internal AST_Index parse_block(Parser* parser) {
+  AST* ast = &parser->ast;
+  Token* token = current_token(parser);
+  Assert(token->type == Token_Open_Brace);
+
+  AST_Index result = ast_node_new(ast, token->start_offset, 0, AST_Node_Block);
+  token = advance_token_skip_trivia(parser);
+
+  while (token->type != Token_Close_Brace && token->type != Token_End_Of_File) {
+    u64 index = parser->index;
+    AST_Index statement = parse_statement(parser);
+    if (statement != AST_NULL) {
+      ast_add_child(ast, result, statement);
+    }
+    if (parser->index == index) {
+      // NOTE(fz): Already reported, step over it so the loop always moves.
+      advance_token_skip_trivia(parser);
+    }
+    parser_recover(parser);
+    token = current_token(parser);
+  }
+
+  parser_expect(parser, Token_Close_Brace);
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
+}
+
+internal AST_Index parse_condition(Parser* parser) {
+  parser_expect(parser, Token_Open_Parenthesis);
+  AST_Index result = parse_expression(parser);
+  parser_expect(parser, Token_Close_Parenthesis);
+  return result;
+}
+
+internal AST_Index parse_jump_statement(Parser* parser, AST_Node_Type type) {
+  AST* ast = &parser->ast;
+  Token* keyword = current_token(parser);
+  AST_Index result = ast_node_new(ast, keyword->start_offset, 0, type);
+  Token* token = advance_token_skip_trivia(parser);
+
+  if (type == AST_Node_Return && token->type != Token_Semicolon) {
+    ast_add_child(ast, result, parse_expression(parser));
+  } else if (type == AST_Node_Goto) {
+    if (token->type == Token_Identifier) {
+      ast_add_child(ast, result, ast_node_new(ast, token->start_offset, token_end_offset(*token), AST_Node_Identifier));
+      advance_token_skip_trivia(parser);
+    } else {
+      parser_emit_error(parser, Parser_Error_Expected_Label, token->start_offset, token_end_offset(*token));
+    }
+  }
+  parser_expect(parser, Token_Semicolon);
+
+  ASTNode(ast, result)->end_offset = parser->previous_end;
+  return result;
 }
 
 ///////////////
 // AST
 
-// TODO(fz): Change arg parser for Arena*
-internal AST_Node* node_new(Arena* arena, u32 start_offset, u32 end_offset, AST_Node_Type type) {
-  AST_Node* node       = arena_push(arena, sizeof(AST_Node));
-  node->arena          = arena;
-  node->children       = NULL;
-  node->children_count = 0;
-  node->children_max   = 0;
-  node->type           = type;
-  node->start_offset   = start_offset;
-  node->end_offset     = end_offset;
-  return node;
-}
-
-internal void node_add_child(AST_Node* parent, AST_Node* child) {
-  Assert(parent->arena == child->arena);
-  if (parent->children_count == parent->children_max) {
-    u32 new_capacity = (parent->children_max == 0) ? 2 : parent->children_max * 2;
-    AST_Node** new_children = ArenaPush(parent->arena, AST_Node*, new_capacity);
-    MemoryCopy(new_children, parent->children, parent->children_count * sizeof(AST_Node*));
-    parent->children = new_children;
-    parent->children_max = new_capacity;
-  }
-  parent->children[parent->children_count] = child;
-  parent->children_count += 1;
-}
-
-internal AST_Node* make_binary(AST_Node* parent, AST_Node* left, AST_Node* right) {
-  node_add_child(parent, left);
-  node_add_child(parent, right);
+internal void ast_init(AST* ast, u64 reserve) {
+  MemoryZeroStruct(ast);
+  ast->arena = parser_arena_init(reserve);
+  ast->nodes = ArenaPushNoZero(ast->arena, AST_Node, AST_NODE_CHUNK_SIZE);
+  ast->capacity = AST_NODE_CHUNK_SIZE;
+
+  // NOTE(fz): Nil node, every link of an empty slot points back here.
+  MemoryZeroStruct(&ast->nodes[AST_NULL]);
+  ast->count = 1;
+  ast->root  = ast_node_new(ast, 0, 0, AST_Node_Program);
+
+  ast->trivia_arena    = parser_arena_init(reserve);
+  ast->trivia          = ArenaPushNoZero(ast->trivia_arena, AST_Trivia, AST_TRIVIA_CHUNK_SIZE);
+  ast->trivia_capacity = AST_TRIVIA_CHUNK_SIZE;
+}
+
+internal void ast_free(AST* ast) {
+  arena_free(ast->trivia_arena);
+  arena_free(ast->arena);
+  MemoryZeroStruct(ast);
+}
+
+internal AST_Index ast_node_new(AST* ast, u32 start_offset, u32 end_offset, AST_Node_Type type) {
+  if (ast->count == ast->capacity) {
+    AST_Node* chunk = ArenaPushNoZero(ast->arena, AST_Node, AST_NODE_CHUNK_SIZE);
+    Assert(chunk == ast->nodes + ast->capacity);
+    ast->capacity += AST_NODE_CHUNK_SIZE;
+  }
+
+  AST_Index index = ast->count;
+  AST_Node* node  = ASTNode(ast, index);
+  node->type         = type;
+  node->start_offset = start_offset;
+  node->end_offset   = end_offset;
+  node->first_child  = AST_NULL;
+  node->last_child   = AST_NULL;
+  node->next_sibling = AST_NULL;
+  ast->count += 1;
+
+  // NOTE(fz): Binary, postfix and directive nodes are created once some of their tokens were consumed. Trivia pushed
+  // since then lies inside the node, not before it, so it leads the next node created instead.
+  u32 pending = ast->trivia_count;
+  while (pending > ast->trivia_pending && ast->tokens->tokens[ast->trivia[pending - 1].token_index].start_offset >= start_offset) {
+    pending -= 1;
+    ast->trivia[pending].node = ast->count;
+  }
+  ast->trivia_pending = pending;
+  return index;
+}
+
+internal void ast_add_child(AST* ast, AST_Index parent, AST_Index child) {
+  Assert(parent != AST_NULL && child != AST_NULL);
+  AST_Node* parent_node = ASTNode(ast, parent);
+  if (parent_node->last_child == AST_NULL) {
+    parent_node->first_child = child;
+  } else {
+    ASTNode(ast, parent_node->last_child)->next_sibling = child;
+  }
+  parent_node->last_child = child;
+}
+
+internal AST_Index ast_make_binary(AST* ast, AST_Index parent, AST_Index left, AST_Index right) {
+  ast_add_child(ast, parent, left);
+  ast_add_child(ast, parent, right);
   return parent;
 }
 
+internal void ast_trivia_push(AST* ast, u32 token_index) {
+  if (ast->trivia_count == ast->trivia_capacity) {
+    AST_Trivia* chunk = ArenaPushNoZero(ast->trivia_arena, AST_Trivia, AST_TRIVIA_CHUNK_SIZE);
+    Assert(chunk == ast->trivia + ast->trivia_capacity);
+    ast->trivia_capacity += AST_TRIVIA_CHUNK_SIZE;
+  }
+
+  // NOTE(fz): Leads the next node created, unless that node starts past it (see ast_node_new).
+  AST_Trivia* trivia  = &ast->trivia[ast->trivia_count];
+  trivia->token_index = token_index;
+  trivia->node        = ast->count;
+  ast->trivia_count += 1;
+}
+
+internal u32 ast_trivia_of(AST* ast, AST_Index node, u32* count) {
+  // Lower bound of node, the table is sorted by node
+  u32 low  = 0;
+  u32 high = ast->trivia_count;
+  while (low < high) {
+    u32 middle = low + (high - low) / 2;
+    if (ast->trivia[middle].node < node) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  u32 end = low;
+  while (end < ast->trivia_count && ast->trivia[end].node == node) {
+    end += 1;
+  }
+  *count = end - low;
+  return low;
+}
+
 internal void print_ast(Parser* parser, Lexer* lexer, b32 print_whitespace, b32 print_comments) {
-  print_ast_node(parser, lexer, parser->root, 0, print_whitespace, print_comments);
+  print_ast_node(parser, lexer, parser->ast.root, 0, print_whitespace, print_comments);
+  print_ast_trivia(parser, lexer, parser->ast.count, 1, print_whitespace, print_comments); // Trailing trivia
 }
 
-internal void print_ast_node(Parser* parser, Lexer* lexer, AST_Node* node, u32 indent, b32 print_whitespace, b32 print_comments) {
-  if (!node) return;
-  if ((node->type == AST_Node_Space || node->type == AST_Node_Tab || node->type == AST_Node_New_Line) && !print_whitespace) return;
-  if ((node->type == AST_Node_Comment_Line || node->type == AST_Node_Comment_Block) && !print_comments) return;
+internal void print_ast_trivia(Parser* parser, Lexer* lexer, AST_Index index, u32 indent, b32 print_whitespace, b32 print_comments) {
+  u32 count = 0;
+  u32 first = ast_trivia_of(&parser->ast, index, &count);
+  for (u32 i = first; i < first + count; i += 1) {
+    Token* token = &parser->tokens.tokens[parser->ast.trivia[i].token_index];
+    b32 is_comment = (token->type == Token_Comment_Line || token->type == Token_Comment_Block);
+    if (is_comment ? !print_comments : !print_whitespace) continue;
 
-  Terminal_Color color = Terminal_Color_Default;
-  switch (node->type) {
-    case AST_Node_Space: 
-    case AST_Node_Tab:
-    case AST_Node_New_Line:{
-      color = Terminal_Color_Gray;
-    } break;
+    for (u32 j = 0; j < indent; ++j) {
+      printf("  ");
+    }
+    Terminal_Color color = is_comment ? Terminal_Color_Yellow : Terminal_Color_Gray;
+    printf_color(color, "{.type=%s, }: %.*s", ast_node_types[node_type_from_trivia_token(token->type)], token->length, lexer->file.data.str + token->start_offset);
+    printf("\n");
+  }
+}
 
-    case AST_Node_Comment_Line:
-    case AST_Node_Comment_Block: {
-      color = Terminal_Color_Yellow;
-    } break;
+internal void print_ast_node(Parser* parser, Lexer* lexer, AST_Index index, u32 indent, b32 print_whitespace, b32 print_comments) {
+  if (index == AST_NULL) return;
+  AST_Node* node = ASTNode(&parser->ast, index);
+  print_ast_trivia(parser, lexer, index, indent, print_whitespace, print_comments);
 
+  Terminal_Color color = Terminal_Color_Default;
+  switch (node->type) {
     case AST_Node_Preprocessor_Define:
     case AST_Node_Preprocessor_Pragma:
     case AST_Node_Preprocessor_Include_System:
@@ -247,7 +1830,7 @@ internal void print_ast_node(Parser* parser, Lexer* lexer, AST_Node* node, u32 i
   printf_color(color, "{.type=%s, }: %.*s", ast_node_types[node->type], size, lexer->file.data.str + node->start_offset);
   printf("\n");
   
-  for (u32 i = 0; i < node->children_count; i += 1) {
-    print_ast_node(parser, lexer, node->children[i], indent + 1, print_whitespace, print_comments);
+  ASTForEachChild(&parser->ast, index, child) {
+    print_ast_node(parser, lexer, child, indent + 1, print_whitespace, print_comments);
   }
 }
\ No newline at end of file
@@ -21,6 +21,11 @@ static const char8* ast_node_types [] = {
   "AST_Node_Mul_Assign",
   "AST_Node_Div_Assign",
   "AST_Node_Mod_Assign",
+  "AST_Node_Left_Shift_Assign",
+  "AST_Node_Right_Shift_Assign",
+  "AST_Node_Bit_And_Assign",
+  "AST_Node_Bit_Or_Assign",
+  "AST_Node_Bit_Xor_Assign",
   "AST_Node_Equal",
   "AST_Node_Not_Equal",
   "AST_Node_Less",
@@ -58,6 +63,47 @@ static const char8* ast_node_types [] = {
   "AST_Node_Identifier",
   "AST_Node_Conditional",
   "AST_Node_Call",
+  "AST_Node_Subscript",
+  "AST_Node_Member",
+  "AST_Node_Pointer_Member",
+  "AST_Node_Sizeof",
+  "AST_Node_Compound_Literal",
+  
+  // Declarations
+  "AST_Node_Function",
+  "AST_Node_Typedef",
+  "AST_Node_Declarator",
+  "AST_Node_Parameter_List",
+  "AST_Node_Parameter",
+  "AST_Node_Variadic",
+  "AST_Node_Array_Dimension",
+  "AST_Node_Bit_Field",
+  "AST_Node_Initializer",
+  "AST_Node_Initializer_List",
+  "AST_Node_Designation",
+  "AST_Node_Designator",
+  "AST_Node_Struct",
+  "AST_Node_Union",
+  "AST_Node_Enum",
+  "AST_Node_Enumerator",
+  "AST_Node_Static_Assert",
+  
+  // Statements
+  "AST_Node_Block",
+  "AST_Node_Expression_Statement",
+  "AST_Node_Empty_Statement",
+  "AST_Node_If",
+  "AST_Node_While",
+  "AST_Node_Do_While",
+  "AST_Node_For",
+  "AST_Node_Switch",
+  "AST_Node_Case",
+  "AST_Node_Default",
+  "AST_Node_Break",
+  "AST_Node_Continue",
+  "AST_Node_Return",
+  "AST_Node_Goto",
+  "AST_Node_Label",
   
   // Whitespace/Comments
   "AST_Node_Space",
@@ -71,6 +117,9 @@ static const char8* ast_node_types [] = {
   "AST_Node_Preprocessor_Include_Local",
   "AST_Node_Preprocessor_Define",
   "AST_Node_Preprocessor_Pragma",
+  "AST_Node_Preprocessor_Directive",
+
+  "AST_Node_Count", // Keep at the end of the enum
 };
 
 typedef enum AST_Node_Type {
@@ -93,6 +142,11 @@ typedef enum AST_Node_Type {
   AST_Node_Mul_Assign,
   AST_Node_Div_Assign,
   AST_Node_Mod_Assign,
+  AST_Node_Left_Shift_Assign,
+  AST_Node_Right_Shift_Assign,
+  AST_Node_Bit_And_Assign,
+  AST_Node_Bit_Or_Assign,
+  AST_Node_Bit_Xor_Assign,
   AST_Node_Equal,
   AST_Node_Not_Equal,
   AST_Node_Less,
@@ -130,6 +184,47 @@ typedef enum AST_Node_Type {
   AST_Node_Identifier,
   AST_Node_Conditional,
   AST_Node_Call,
+  AST_Node_Subscript,
+  AST_Node_Member,
+  AST_Node_Pointer_Member,
+  AST_Node_Sizeof,
+  AST_Node_Compound_Literal,
+  
+  // Declarations
+  AST_Node_Function,
+  AST_Node_Typedef,
+  AST_Node_Declarator,
+  AST_Node_Parameter_List,
+  AST_Node_Parameter,
+  AST_Node_Variadic,
+  AST_Node_Array_Dimension,
+  AST_Node_Bit_Field,
+  AST_Node_Initializer,
+  AST_Node_Initializer_List,
+  AST_Node_Designation,
+  AST_Node_Designator,
+  AST_Node_Struct,
+  AST_Node_Union,
+  AST_Node_Enum,
+  AST_Node_Enumerator,
+  AST_Node_Static_Assert,
+  
+  // Statements
+  AST_Node_Block,
+  AST_Node_Expression_Statement,
+  AST_Node_Empty_Statement,
+  AST_Node_If,
+  AST_Node_While,
+  AST_Node_Do_While,
+  AST_Node_For,
+  AST_Node_Switch,
+  AST_Node_Case,
+  AST_Node_Default,
+  AST_Node_Break,
+  AST_Node_Continue,
+  AST_Node_Return,
+  AST_Node_Goto,
+  AST_Node_Label,
   
   // Whitespace/Comments
   AST_Node_Space,
@@ -143,31 +238,122 @@ typedef enum AST_Node_Type {
   AST_Node_Preprocessor_Include_Local,
   AST_Node_Preprocessor_Define,
   AST_Node_Preprocessor_Pragma,
+  AST_Node_Preprocessor_Directive, // Any other directive, kept whole up to the end of its line
+
+  AST_Node_Count, // Keep at the end of the enum
 } AST_Node_Type;
 
+// DOC(fz): Flat AST. Every node of a file lives in one contiguous array and links to the others by 32 bit index.
+// Children are a singly linked list (first_child -> next_sibling), last_child makes appending O(1).
+// Index 0 is a nil node that links to itself, so following AST_NULL never leaves the array.
+typedef u32 AST_Index;
+#define AST_NULL 0
+
 typedef struct AST_Node {
-  Arena* arena;
-  struct AST_Node** children;
-  u32 children_count;
-  u32 children_max;
   AST_Node_Type type;
   u32 start_offset;
   u32 end_offset;
+  AST_Index first_child;
+  AST_Index last_child;
+  AST_Index next_sibling;
 } AST_Node;
+StaticAssert(sizeof(AST_Node) == 24, ast_node_size_check);
+
+// DOC(fz): Spaces, tabs, newlines and comments don't become nodes. Each one is a trivia entry that points at its token
+// and at the significant node that follows it (its leading trivia): the first node created after it that starts at or
+// after it. Trivia after the last node points at AST.count. Entries are appended in source order and only ever move to
+// later nodes, so the table is sorted by both.
+typedef struct AST_Trivia {
+  u32 token_index;
+  AST_Index node;
+} AST_Trivia;
+
+typedef struct AST {
+  Arena* arena; // Holds nodes only, so they stay contiguous and pointers into it stay valid
+  AST_Node* nodes;
+  u32 count;
+  u32 capacity;
+  AST_Index root;
+
+  Arena* trivia_arena; // Holds trivia only, same reason
+  AST_Trivia* trivia;
+  u32 trivia_count;
+  u32 trivia_capacity;
+  u32 trivia_pending;  // Entries from here on lead AST.count for now, ast_node_new may move them on
+  Token_Array* tokens; // The parser's, where ast_node_new reads the offsets of pending trivia
+} AST;
+#define AST_NODE_CHUNK_SIZE   1024
+#define AST_TRIVIA_CHUNK_SIZE 1024
+
+#define ASTNode(ast, index) (&(ast)->nodes[(index)])
+#define ASTForEachChild(ast, parent, child) for (AST_Index child = ASTNode(ast, parent)->first_child; child != AST_NULL; child = ASTNode(ast, child)->next_sibling)
 
 ///////////////
 // Parser
 
+static const char8* parser_error_formats[] = {
+  "",
+  "Expected %.*s but got %.*s",
+  "Expected an expression",
+  "Expected a member name",
+  "Expected a declaration",
+  "Expected a declarator",
+  "Expected a declarator name",
+  "Expected a parameter",
+  "Expected a name or a body",
+  "Expected a label",
+  "Expected <file> or \"file\" after #include",
+};
+
+typedef enum Parser_Error_Code {
+  Parser_Error_None = 0,
+  Parser_Error_Expected_Token, // Arguments: expected, got
+  Parser_Error_Expected_Expression,
+  Parser_Error_Expected_Member_Name,
+  Parser_Error_Expected_Declaration,
+  Parser_Error_Expected_Declarator,
+  Parser_Error_Expected_Declarator_Name,
+  Parser_Error_Expected_Parameter,
+  Parser_Error_Expected_Name_Or_Body,
+  Parser_Error_Expected_Label,
+  Parser_Error_Expected_Include_Path,
+  Parser_Error_Code_Count,
+} Parser_Error_Code;
+StaticAssert(ArrayCount(parser_error_formats) == Parser_Error_Code_Count, parser_error_formats_check);
+
+// DOC(fz): Errors are stored as records, the text is only built when something reports them (parser_error_format).
+// Arguments are ids into the parser's string table, every distinct string is stored once per file however many
+// errors use it, so emitting an error allocates nothing once its strings are known.
+#define PARSER_ERROR_ARGUMENT_COUNT 2
+
 typedef struct Parser_Error {
-  String8 message;
+  Parser_Error_Code code;
   u32 start_offset;
   u32 end_offset;
+  u32 arguments[PARSER_ERROR_ARGUMENT_COUNT]; // Parser_Strings ids, 0 is the empty string
 } Parser_Error;
+StaticAssert(sizeof(Parser_Error) == 20, parser_error_size_check);
+
+typedef struct Parser_Strings {
+  Arena* arena;     // Holds the String8 entries only, so ids index one contiguous array
+  String8* strings; // id -> text, id 0 is the empty string
+  u32 count;
+  u32 capacity;
+
+  Arena* slots_arena; // Text bytes and the hash slots, slots are rebuilt twice as big when half full
+  u32* slots;         // Open addressing on the text, 0 is an empty slot
+  u32 slots_count;
+} Parser_Strings;
+#define PARSER_ERROR_CHUNK_SIZE   256
+#define PARSER_STRINGS_CHUNK_SIZE 256
+
+// NOTE(fz): Typedef names declared in the file being parsed. Like the string slots, the table is rebuilt twice as big
+// in strings.slots_arena when half full, so a file can declare any number of them.
+#define PARSER_TYPEDEF_FIRST_BITS 8
 
 typedef struct Parser {
-  Arena* arena;
-  Arena* nodes_arena;
-  AST_Node* root;
+  Arena* arena; // Holds errors only, so they stay contiguous
+  AST ast;
 
 #if DEBUG
   File_Data* file;
@@ -175,36 +361,148 @@ typedef struct Parser {
 
   Token_Array tokens;
   u64 index;
+  u32 previous_end;         // End offset of the last significant token advanced past, where the node being built ends
+  Token_Type previous_type; // Type of that token, tells recovery whether the last construct ended cleanly
+  b32 is_recovering;        // Set by the first error, further errors are dropped until the parser synchronizes
   
   Parser_Error* errors;
   u32 errors_count;
-  u32 errors_cap;
+  u32 errors_capacity;
+  Parser_Strings strings;
+
+  AST_Index* typedef_names; // Open addressing on the name's intern id, AST_NULL is an empty slot
+  Intern_Id* typedef_ids;   // Of the name in the same slot
+  u32 typedef_count;
+  u32 typedef_capacity;     // 1 << typedef_bits, 0 for a parser loaded from the cache
+  u32 typedef_bits;
 } Parser;
-#define PARSER_ERROR_CAPACITY 32
 
-internal AST_Node* parse_ast(Parser* parser, Token_Array tokens);
-internal AST_Node* get_top_level_construct(Parser* parser);
+///////////////
+// Expressions
+// DOC(fz): Pratt parser. One loop per operand climbs the table below instead of one function per C precedence level.
+// Left associative operators parse their right side one level higher, assignment and ?: at their own level.
+typedef enum Expression_Precedence {
+  Precedence_None = 0,
+  Precedence_Comma,          // ,
+  Precedence_Assignment,     // = += -= *= /= %= <<= >>= &= ^= |=   (right)
+  Precedence_Conditional,    // ?:                                 (right)
+  Precedence_Logical_Or,     // ||
+  Precedence_Logical_And,    // &&
+  Precedence_Bit_Or,         // |
+  Precedence_Bit_Xor,        // ^
+  Precedence_Bit_And,        // &
+  Precedence_Equality,       // == !=
+  Precedence_Relational,     // < <= > >=
+  Precedence_Shift,          // << >>
+  Precedence_Additive,       // + -
+  Precedence_Multiplicative, // * / %
+  Precedence_Unary,          // + - ! ~ * & ++ -- casts sizeof     (prefix)
+  Precedence_Postfix,        // () [] . -> ++ --
+} Expression_Precedence;
+
+internal AST*      parse_ast(Parser* parser, Token_Array tokens); /* tokens must be lexed with Lexer_Flag_Intern, names are told apart by id */
+internal void      parser_init(Parser* parser, Token_Array tokens, u64 reserve); /* reserve as in parser_arena_init */
+internal void      parser_free(Parser* parser); /* Releases nodes and errors, tokens belong to the lexer */
+internal Arena*    parser_arena_init(u64 reserve); /* Default arena for 0, a resident one of reserve bytes otherwise */
+internal AST_Index parse_top_level(Parser* parser); /* One iteration of the top level loop: a construct, the step over a stray token and recovery. Returns the construct or AST_NULL */
+internal AST_Index get_top_level_construct(Parser* parser);
 
 // Parser token modifying
 internal Token* peek_token(Parser* parser, u64 offset);
 internal Token* advance_token(Parser* parser);
-internal Token* advance_token_skip_trivia(Parser* parser, AST_Node* parent);
-internal Token* assert_token(Parser* parser, Token_Type type);
+internal Token* advance_token_skip_trivia(Parser* parser); /* Trivia skipped over goes to the trivia table */
+internal Token* peek_token_skip_trivia(Parser* parser, u64* offset); /* First non trivia token at or after offset, offset is moved onto it */
+internal String8 parser_token_value(Parser* parser, Token* token); /* Source text of token */
 
 // Parser help
-internal AST_Node* parse_preprocessor(Parser* parser);
-internal void      parser_emit_error(Parser* parser, u32 start_offset, u32 end_offset, String8 message);
+internal AST_Index parse_preprocessor(Parser* parser);
+internal Token*    parser_skip_trivia(Parser* parser);                  /* Moves past trivia at the current token, if any */
+internal b32       parser_expect(Parser* parser, Token_Type type);      /* Advances past type or emits an error and stays */
+internal b32       parser_is_type_name(Parser* parser, Token* token);  /* Keyword, builtin or typedef name that can start a type */
+internal b32       parser_is_cast(Parser* parser);                     /* Current token is the '(' of a cast */
+
+// Expression
+internal AST_Index parse_expression(Parser* parser);                                             /* Full expression, comma included */
+internal AST_Index parse_expression_with_precedence(Parser* parser, Expression_Precedence min); /* Stops at operators binding looser than min */
+internal AST_Index parse_expression_prefix(Parser* parser);
+internal AST_Index parse_expression_postfix(Parser* parser, AST_Index left, u32 start);
+internal AST_Index parse_type_name(Parser* parser); /* Tokens of a type up to the closing ')', as one Data_Type node */
+
+// Errors
+internal void    parser_emit_error(Parser* parser, Parser_Error_Code code, u32 start_offset, u32 end_offset);
+internal void    parser_emit_error_arguments(Parser* parser, Parser_Error_Code code, u32 start_offset, u32 end_offset, String8 first, String8 second);
+internal void    parser_emit_error_expected(Parser* parser, Token_Type expected, Token* got); /* Expected <expected> but got <got> */
+internal String8 parser_error_format(Arena* arena, Parser_Error_Code code, String8* arguments); /* Message text, arguments has PARSER_ERROR_ARGUMENT_COUNT entries */
+
+// Error strings
+internal void    parser_strings_init(Parser_Strings* table, u64 reserve);
+internal void    parser_strings_free(Parser_Strings* table);
+internal u32     parser_strings_intern(Parser_Strings* table, String8 value); /* Id of value, stored the first time it is seen */
+
+///////////////
+// Error recovery
+// DOC(fz): Errors never stop the parse. The first error of a construct is recorded and the ones after it are dropped.
+// Once the statement, member or top level loop gets control back it synchronizes: skips past the next ';',
+// or up to the next '}' or the '#' of a directive, and parsing picks up from there.
+internal void parser_recover(Parser* parser);     /* Synchronizes if an error was emitted since the last call */
+internal void parser_synchronize(Parser* parser); /* Skips to the next synchronization point */
+internal b32  parser_is_line_start(Parser* parser, u64 index); /* Only whitespace between the token and the previous newline */
+
+///////////////
+// Declarations
+// DOC(fz): Recursive descent, one function per construct, every node comes from the AST arena.
+// Declaration  -> Data_Type, Declarator...         (Typedef and Function have the same shape, Function ends in a Block)
+// Data_Type    -> Struct | Union | Enum, when the specifiers define or name one
+// Declarator   -> Identifier | Declarator, then Parameter_List / Array_Dimension suffixes in source order,
+//                 then Bit_Field or Initializer. Pointer stars and qualifiers are in the span but get no node.
+// Parameter    -> Data_Type, Declarator (abstract ones may have no Identifier)
+internal AST_Index parse_declaration(Parser* parser, b32 allow_function);        /* Declaration up to and including ';', or a function definition */
+internal AST_Index parse_declaration_specifiers(Parser* parser, b32* is_typedef); /* Data_Type node, AST_NULL when there are no specifiers */
+internal AST_Index parse_declarator(Parser* parser, b32 is_abstract);           /* AST_NULL when an abstract declarator is empty */
+internal AST_Index parse_parameter_list(Parser* parser);
+internal AST_Index parse_record(Parser* parser);                                /* struct, union or enum, with or without a body */
+internal AST_Index parse_initializer(Parser* parser);
+internal AST_Index parse_initializer_list(Parser* parser);
+internal AST_Index parse_static_assert(Parser* parser);
+internal b32       parser_is_declaration_start(Parser* parser);                 /* Current token starts a declaration rather than a statement */
+internal b32       parser_is_nested_declarator(Parser* parser);                 /* Current '(' opens a declarator, not a parameter list */
+internal AST_Index declarator_name(AST* ast, AST_Index declarator);             /* Identifier node of a declarator, AST_NULL if abstract */
+
+// Typedef names
+internal u32  parser_string_hash(String8 name);
+internal u32  parser_id_slot(Intern_Id id, u32 bits);
+internal void parser_typedef_add(Parser* parser, AST_Index name);
+internal b32  parser_typedef_exists(Parser* parser, Intern_Id id);
+internal void parser_typedef_grow(Parser* parser, u32 bits); /* Rebuilds the table with 1 << bits slots */
+
+///////////////
+// Statements
+// DOC(fz): Each statement node holds its parts as children in source order. For leaves out a missing part as
+// an Empty_Statement so init, condition, step and body are always the first four children.
+// Case, Default and Label own the one statement that follows them, like the C grammar.
+internal AST_Index parse_statement(Parser* parser);
+internal AST_Index parse_block(Parser* parser);                 /* { ... } */
+internal AST_Index parse_condition(Parser* parser);             /* ( expression ), for if, while and switch */
+internal AST_Index parse_jump_statement(Parser* parser, AST_Node_Type type); /* break, continue, return and goto */
+
+// Preprocessor lines
+internal Token* advance_token_in_line(Parser* parser); /* Like advance_token_skip_trivia but stops on the newline ending the directive */
 
 // Token help
 internal b32 is_token_trivia(Token token);
 internal AST_Node_Type node_type_from_trivia_token(Token_Type type);
 
-// AST
-internal AST_Node* node_new(Arena* arena, u32 start_offset, u32 end_offset, AST_Node_Type type);
-internal void      node_add_child(AST_Node* parent, AST_Node* child);
-internal AST_Node* make_binary(AST_Node* parent, AST_Node* left, AST_Node* right);
+// AST builder
+internal void      ast_init(AST* ast, u64 reserve);
+internal void      ast_free(AST* ast);
+internal AST_Index ast_node_new(AST* ast, u32 start_offset, u32 end_offset, AST_Node_Type type);
+internal void      ast_add_child(AST* ast, AST_Index parent, AST_Index child);
+internal AST_Index ast_make_binary(AST* ast, AST_Index parent, AST_Index left, AST_Index right);
+internal void      ast_trivia_push(AST* ast, u32 token_index);
+internal u32       ast_trivia_of(AST* ast, AST_Index node, u32* count); /* First trivia entry leading node, count is set to how many */
 
 internal void print_ast(Parser* parser, Lexer* lexer, b32 print_whitespace, b32 print_comments);
-internal void print_ast_node(Parser* parser, Lexer* lexer, AST_Node* node, u32 indent, b32 print_whitespace, b32 print_comments);
+internal void print_ast_node(Parser* parser, Lexer* lexer, AST_Index index, u32 indent, b32 print_whitespace, b32 print_comments);
+internal void print_ast_trivia(Parser* parser, Lexer* lexer, AST_Index index, u32 indent, b32 print_whitespace, b32 print_comments);
 
 #endif // PARSER_H
\ No newline at end of file
@@ -0,0 +1,304 @@
+///////////////
+// Rules
+internal void rules_init() {
+  Rule_Dispatch* dispatch = &RuleDispatch;
+  if (dispatch->is_ready) {
+    return;
+  }
+
+  // Counting sort on the type: count, prefix sum, then place. Hooks of one type keep their table order.
+  MemoryZeroStruct(dispatch);
+  for (u32 i = 0; i < ArrayCount(rule_token_hooks); i += 1) {
+    dispatch->token_first[rule_token_hooks[i].type + 1] += 1;
+  }
+  for (u32 i = 0; i < Token_Count; i += 1) {
+    dispatch->token_first[i + 1] += dispatch->token_first[i];
+  }
+  u32 token_next[Token_Count];
+  MemoryCopy(token_next, dispatch->token_first, sizeof(token_next));
+  for (u32 i = 0; i < ArrayCount(rule_token_hooks); i += 1) {
+    dispatch->token_funcs[token_next[rule_token_hooks[i].type]++] = rule_token_hooks[i].func;
+  }
+
+  for (u32 i = 0; i < ArrayCount(rule_node_hooks); i += 1) {
+    dispatch->node_first[rule_node_hooks[i].type + 1] += 1;
+  }
+  for (u32 i = 0; i < AST_Node_Count; i += 1) {
+    dispatch->node_first[i + 1] += dispatch->node_first[i];
+  }
+  u32 node_next[AST_Node_Count];
+  MemoryCopy(node_next, dispatch->node_first, sizeof(node_next));
+  for (u32 i = 0; i < ArrayCount(rule_node_hooks); i += 1) {
+    dispatch->node_funcs[node_next[rule_node_hooks[i].type]++] = rule_node_hooks[i].func;
+  }
+
+  dispatch->is_ready = true;
+}
+
+internal void rules_run(Arena* arena, Rule_Context* context, Token_Array* tokens, AST* ast, String8 path) {
+  Rule_Dispatch* dispatch = &RuleDispatch;
+  Assert(dispatch->is_ready);
+
+  MemoryZeroStruct(context);
+  context->source       = tokens->source;
+  context->tokens       = tokens->tokens;
+  context->tokens_count = tokens->count;
+  context->ast          = ast;
+  context->is_header    = file_has_extension(path, Str8(".h"));
+
+  context->arena                = arena;
+  context->diagnostics          = ArenaPushNoZero(arena, Rule_Diagnostic, RULE_DIAGNOSTIC_CHUNK_SIZE);
+  context->diagnostics_capacity = RULE_DIAGNOSTIC_CHUNK_SIZE;
+
+  // Bytes
+  for (u32 i = 0; i < ArrayCount(rule_source_hooks); i += 1) {
+    rule_source_hooks[i](context);
+  }
+
+  // Tokens, in source order
+  for (u64 i = 0; i < context->tokens_count; i += 1) {
+    Token_Type type = context->tokens[i].type;
+    for (u32 k = dispatch->token_first[type]; k < dispatch->token_first[type + 1]; k += 1) {
+      dispatch->token_funcs[k](context, i);
+    }
+  }
+
+  // NOTE(fz): Pre-order from the root, so only nodes that made it into the tree are visited. The stack grows in
+  // chunks like the AST, deep expression chains nest one level per operator.
+  if (ast == NULL || ast->count == 0 || ast->root == AST_NULL) {
+    return;
+  }
+  Arena_Temp scratch = scratch_begin(&arena, 1);
+  Rule_Visit* stack  = ArenaPushNoZero(scratch.arena, Rule_Visit, RULE_STACK_CHUNK_SIZE);
+  u64 stack_capacity = RULE_STACK_CHUNK_SIZE;
+  u64 stack_count    = 1;
+  stack[0] = (Rule_Visit){ ast->root, AST_NULL };
+
+  while (stack_count > 0) {
+    stack_count -= 1;
+    Rule_Visit visit = stack[stack_count];
+    AST_Node_Type type = ASTNode(ast, visit.node)->type;
+    for (u32 k = dispatch->node_first[type]; k < dispatch->node_first[type + 1]; k += 1) {
+      dispatch->node_funcs[k](context, visit.node, visit.parent);
+    }
+
+    // Children are pushed first to last, every one of them is popped before anything below visit is
+    u64 children_start = stack_count;
+    ASTForEachChild(ast, visit.node, child) {
+      if (stack_count == stack_capacity) {
+        Rule_Visit* chunk = ArenaPushNoZero(scratch.arena, Rule_Visit, RULE_STACK_CHUNK_SIZE);
+        Assert(chunk == stack + stack_capacity);
+        stack_capacity += RULE_STACK_CHUNK_SIZE;
+      }
+      stack[stack_count] = (Rule_Visit){ child, visit.node };
+      stack_count += 1;
+    }
+    // Reversed so the first child is on top and nodes come off in source order
+    for (u64 low = children_start, high = stack_count; low + 1 < high; low += 1, high -= 1) {
+      Rule_Visit swap = stack[low];
+      stack[low]      = stack[high - 1];
+      stack[high - 1] = swap;
+    }
+  }
+  scratch_end(&scratch);
+}
+
+internal String8 rule_format(Arena* arena, Rule_Code code, String8 argument) {
+  Assert(code < Rule_Code_Count);
+  String8 format = string8_from_cstring((char8*)rule_formats[code]);
+  String8 result = string8_format(arena, format, (s32)argument.size, argument.str);
+  return result;
+}
+
+///////////////
+// Rule hooks
+internal void rule_case_braces(Rule_Context* context, AST_Index node, AST_Index parent) {
+  // case X: holds the label then the first statement, default: only the statement
+  AST* ast = context->ast;
+  AST_Node* case_node = ASTNode(ast, node);
+  AST_Index statement = (case_node->type == AST_Node_Case) ? ASTNode(ast, case_node->first_child)->next_sibling : case_node->first_child;
+  if (statement == AST_NULL) {
+    return;
+  }
+
+  // Falling through to the next label is fine, that label gets checked on its own
+  AST_Node_Type type = ASTNode(ast, statement)->type;
+  if (type != AST_Node_Block && type != AST_Node_Case && type != AST_Node_Default) {
+    rule_emit(context, Rule_Case_Braces, case_node->start_offset, ASTNode(ast, statement)->start_offset, (String8){0});
+  }
+}
+
+internal void rule_codebase_types(Rule_Context* context, AST_Index node, AST_Index parent) {
+  AST* ast = context->ast;
+  if (ASTNode(ast, parent)->type == AST_Node_Typedef) {
+    return;
+  }
+
+  // NOTE(fz): Only the type's own tokens, a struct or enum body inside it has Data_Types of its own.
+  AST_Node* type_node = ASTNode(ast, node);
+  AST_Index child     = type_node->first_child;
+  for (u64 i = rule_token_at(context, type_node->start_offset); i < context->tokens_count; i += 1) {
+    Token* token = &context->tokens[i];
+    if (token->start_offset >= type_node->end_offset) break;
+    while (child != AST_NULL && ASTNode(ast, child)->end_offset <= token->start_offset) {
+      child = ASTNode(ast, child)->next_sibling;
+    }
+    if (child != AST_NULL && ASTNode(ast, child)->start_offset <= token->start_offset) continue;
+    if (token->type != Token_Identifier) continue;
+
+    if (HasFlags(intern_flags(token->id), Intern_Flag_C_Type)) {
+      rule_emit(context, Rule_Codebase_Types, token->start_offset, token_end_offset(*token), token_value(context->source, *token));
+    }
+  }
+}
+
+internal void rule_internal_functions(Rule_Context* context, AST_Index node, AST_Index parent) {
+  AST* ast = context->ast;
+  AST_Index type       = rule_child_of_type(ast, node, AST_Node_Data_Type);
+  AST_Index declarator = rule_child_of_type(ast, node, AST_Node_Declarator);
+
+  // int (*name(void))(void) nests the name in declarators
+  AST_Index name = ASTNode(ast, declarator)->first_child;
+  while (name != AST_NULL && ASTNode(ast, name)->type == AST_Node_Declarator) {
+    name = ASTNode(ast, name)->first_child;
+  }
+  if (name == AST_NULL || ASTNode(ast, name)->type != AST_Node_Identifier) {
+    return;
+  }
+  AST_Node* name_node = ASTNode(ast, name);
+  Token* name_token   = &context->tokens[rule_token_at(context, name_node->start_offset)];
+  if (name_token->type == Token_Identifier && name_token->id == InternNames[Intern_Name_Main]) {
+    return;
+  }
+
+  if (type != AST_NULL) {
+    AST_Node* type_node = ASTNode(ast, type);
+    for (u64 i = rule_token_at(context, type_node->start_offset); i < context->tokens_count; i += 1) {
+      Token* token = &context->tokens[i];
+      if (token->start_offset >= type_node->end_offset) break;
+      if (token->type == Token_Identifier && token->id == InternNames[Intern_Name_Internal]) {
+        return;
+      }
+    }
+  }
+  String8 name_value = string8_slice(context->source, name_node->start_offset, name_node->end_offset);
+  rule_emit(context, Rule_Internal_Functions, name_node->start_offset, name_node->end_offset, name_value);
+}
+
+internal void rule_whitespace(Rule_Context* context) {
+  // NOTE(fz): Straight from the bytes, so tabs inside comments count too and no tokens are needed.
+  char8* start = context->source.str;
+  char8* end   = start + context->source.size;
+  for (char8* at = scan_find_whitespace_issue(start, end); at < end; at = scan_find_whitespace_issue(at, end)) {
+    char8* run_end = at + 1;
+    if (*at == '\t') {
+      run_end = scan_skip_byte(at, end, '\t');
+      rule_emit(context, Rule_No_Tabs, (u32)(at - start), (u32)(run_end - start), (String8){0});
+      if (run_end < end && *run_end != '\n' && *run_end != '\r') {
+        at = run_end;
+        continue;
+      }
+    }
+
+    // run_end ends the line. Spaces and tabs before it are one run ("\t  \n" is a blank line), the line is only
+    // whitespace if the run starts it.
+    char8* run_start = at;
+    while (run_start > start && (run_start[-1] == ' ' || run_start[-1] == '\t')) {
+      run_start -= 1;
+    }
+    b32 is_whole_line = (run_start == start) || (run_start[-1] == '\n') || (run_start[-1] == '\r');
+    rule_emit(context, is_whole_line ? Rule_Leading_Spaces : Rule_Trailing_Spaces, (u32)(run_start - start), (u32)(run_end - start), (String8){0});
+    at = run_end;
+  }
+}
+
+internal void rule_todo_format(Rule_Context* context, u64 token_index) {
+  // NOTE(fz): Only what is meant as a tag is checked, TODO in capitals or todo followed by ( or :. Prose like todo.txt is left alone.
+  Token* token = &context->tokens[token_index];
+  String8 text = token_value(context->source, *token);
+  for (u64 at = rule_find_word(text, 0, Str8("todo")); at < text.size; at = rule_find_word(text, at + 4, Str8("todo"))) {
+    u64 end = at + 4;
+    b32 is_upper = MemoryMatch(text.str + at, "TODO", 4);
+    if (!is_upper && (end == text.size || (text.str[end] != '(' && text.str[end] != ':'))) {
+      continue;
+    }
+
+    // Upper case, the user in parentheses, then a colon
+    b32 is_valid = is_upper && end < text.size && text.str[end] == '(';
+    u64 user = end + 1;
+    while (is_valid && user < text.size && (char8_is_alphanum(text.str[user]) || text.str[user] == '_')) {
+      user += 1;
+    }
+    is_valid = is_valid && user > end + 1 && user + 1 < text.size && text.str[user] == ')' && text.str[user + 1] == ':';
+    if (!is_valid) {
+      // The tag as written, up to the first space
+      u64 tag_end = end;
+      while (tag_end < text.size && !char8_is_space(text.str[tag_end]) && tag_end - at < 32) {
+        tag_end += 1;
+      }
+      rule_emit(context, Rule_Todo_Format, token->start_offset + (u32)at, token->start_offset + (u32)tag_end, string8_new(tag_end - at, text.str + at));
+    }
+  }
+}
+
+internal void rule_doc_placement(Rule_Context* context, u64 token_index) {
+  if (context->is_header) {
+    return;
+  }
+  Token* token = &context->tokens[token_index];
+  String8 text = token_value(context->source, *token);
+  for (u64 at = rule_find_word(text, 0, Str8("doc")); at < text.size; at = rule_find_word(text, at + 3, Str8("doc"))) {
+    if (MemoryMatch(text.str + at, "DOC", 3) && at + 3 < text.size && text.str[at + 3] == '(') {
+      rule_emit(context, Rule_Doc_Placement, token->start_offset + (u32)at, token->start_offset + (u32)at + 3, (String8){0});
+      break;
+    }
+  }
+}
+
+///////////////
+// Rules help
+internal void rule_emit(Rule_Context* context, Rule_Code code, u32 start_offset, u32 end_offset, String8 argument) {
+  if (context->diagnostics_count == context->diagnostics_capacity) {
+    Rule_Diagnostic* chunk = ArenaPushNoZero(context->arena, Rule_Diagnostic, RULE_DIAGNOSTIC_CHUNK_SIZE);
+    Assert(chunk == context->diagnostics + context->diagnostics_capacity);
+    context->diagnostics_capacity += RULE_DIAGNOSTIC_CHUNK_SIZE;
+  }
+
+  Rule_Diagnostic* diagnostic = &context->diagnostics[context->diagnostics_count];
+  diagnostic->code         = code;
+  diagnostic->start_offset = start_offset;
+  diagnostic->end_offset   = end_offset;
+  diagnostic->argument     = argument;
+  context->diagnostics_count += 1;
+}
+
+internal u64 rule_token_at(Rule_Context* context, u32 offset) {
+  u64 result = token_index_at(context->tokens, context->tokens_count, offset);
+  return result;
+}
+
+internal AST_Index rule_child_of_type(AST* ast, AST_Index parent, AST_Node_Type type) {
+  ASTForEachChild(ast, parent, child) {
+    if (ASTNode(ast, child)->type == type) {
+      return child;
+    }
+  }
+  return AST_NULL;
+}
+
+internal u64 rule_find_word(String8 text, u64 offset, String8 word) {
+  for (u64 i = offset; i + word.size <= text.size; i += 1) {
+    if (char8_to_lower(text.str[i]) != word.str[0]) continue;
+    if (i > 0 && (char8_is_alphanum(text.str[i - 1]) || text.str[i - 1] == '_')) continue;
+
+    u64 k = 1;
+    while (k < word.size && char8_to_lower(text.str[i + k]) == word.str[k]) {
+      k += 1;
+    }
+    if (k < word.size) continue;
+    u64 end = i + word.size;
+    if (end < text.size && (char8_is_alphanum(text.str[end]) || text.str[end] == '_')) continue;
+    return i;
+  }
+  return text.size;
+}
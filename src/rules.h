@@ -0,0 +1,151 @@
+#ifndef RULES_H
+#define RULES_H
+
+// DOC(fz): Codebase style rules (todo.txt, Static Analysis Features) fused into one pass per file. A rule is a set of
+// hooks, each on one token type or one AST node type. rules_init sorts every hook by type into RuleDispatch once, then
+// rules_run walks the tokens once and the tree once, calling only the hooks registered for what it is standing on.
+// Adding a rule adds hooks, never another walk over the file.
+//
+// Rules only read tokens and the tree, so they run the same on a fresh parse, a cache entry or a Document. What they
+// find is kept as compact records like parser errors, the message is built when something reports it (rule_format).
+// Without a tree (lint mode) only the token hooks run, so a rule that can be answered from tokens should be one.
+// Rules that only need bytes are source hooks. They run first, once per file, even with no tokens (whitespace mode).
+
+static const char8* rule_names[] = {
+  "",
+  "case-braces",
+  "codebase-types",
+  "internal-functions",
+  "no-tabs",
+  "leading-spaces",
+  "todo-format",
+  "doc-placement",
+  "trailing-spaces",
+  "header-order",
+  "missing-definition",
+  "header-function-bodies",
+};
+
+static const char8* rule_formats[] = {
+  "",
+  "Statements of a case should be in { }",
+  "Use a codebase type instead of '%.*s'",
+  "Function '%.*s' should be internal",
+  "Tab instead of spaces",
+  "Line holds only spaces",
+  "'%.*s' should look like TODO(user):",
+  "DOC comments belong in the header",
+  "Spaces at the end of the line",
+  "Function '%.*s' is defined out of the header's order",
+  "Function '%.*s' is declared but never defined",
+  "Function '%.*s' is defined in a header",
+};
+
+typedef enum Rule_Code {
+  Rule_None = 0,
+  Rule_Case_Braces,
+  Rule_Codebase_Types,     // Argument: the C type. Only typedefs may name it
+  Rule_Internal_Functions, // Argument: function name. main is exempt
+  Rule_No_Tabs,
+  Rule_Leading_Spaces,
+  Rule_Todo_Format,        // Argument: the tag as written
+  Rule_Doc_Placement,      // DOC( in an implementation file
+  Rule_Trailing_Spaces,
+  // NOTE(fz): Cross file, raised by symbols_check once every file is in the index rather than by a hook.
+  Rule_Header_Order,           // Argument: function name. X.c defines in the order X.h declares
+  Rule_Missing_Definition,     // Argument: function name
+  Rule_Header_Function_Bodies, // Argument: function name
+  Rule_Code_Count,
+} Rule_Code;
+StaticAssert(ArrayCount(rule_names)   == Rule_Code_Count, rule_names_check);
+StaticAssert(ArrayCount(rule_formats) == Rule_Code_Count, rule_formats_check);
+
+typedef struct Rule_Diagnostic {
+  Rule_Code code;
+  u32 start_offset;
+  u32 end_offset;
+  String8 argument; // Points into the source
+} Rule_Diagnostic;
+
+typedef struct Rule_Context {
+  String8 source;
+  Token* tokens;
+  u64 tokens_count;
+  AST* ast; // NULL in lint and whitespace mode
+  b32 is_header;
+
+  Arena* arena; // Holds diagnostics only, so they stay contiguous
+  Rule_Diagnostic* diagnostics;
+  u32 diagnostics_count;
+  u32 diagnostics_capacity;
+} Rule_Context;
+#define RULE_DIAGNOSTIC_CHUNK_SIZE 256
+#define RULE_STACK_CHUNK_SIZE      256
+
+typedef void rule_source_func(Rule_Context* context);
+typedef void rule_token_func(Rule_Context* context, u64 token_index);
+typedef void rule_node_func(Rule_Context* context, AST_Index node, AST_Index parent);
+
+typedef struct Rule_Token_Hook {
+  Token_Type type;
+  rule_token_func* func;
+} Rule_Token_Hook;
+
+typedef struct Rule_Node_Hook {
+  AST_Node_Type type;
+  rule_node_func* func;
+} Rule_Node_Hook;
+
+// Node being walked and the node it is a child of
+typedef struct Rule_Visit {
+  AST_Index node;
+  AST_Index parent;
+} Rule_Visit;
+
+internal void rule_case_braces(Rule_Context* context, AST_Index node, AST_Index parent);
+internal void rule_codebase_types(Rule_Context* context, AST_Index node, AST_Index parent);
+internal void rule_internal_functions(Rule_Context* context, AST_Index node, AST_Index parent);
+internal void rule_whitespace(Rule_Context* context); /* no-tabs, leading-spaces and trailing-spaces */
+internal void rule_todo_format(Rule_Context* context, u64 token_index);
+internal void rule_doc_placement(Rule_Context* context, u64 token_index);
+
+static rule_source_func* const rule_source_hooks[] = {
+  rule_whitespace,
+};
+
+static const Rule_Token_Hook rule_token_hooks[] = {
+  { Token_Comment_Line,  rule_todo_format },
+  { Token_Comment_Block, rule_todo_format },
+  { Token_Comment_Line,  rule_doc_placement },
+  { Token_Comment_Block, rule_doc_placement },
+};
+
+static const Rule_Node_Hook rule_node_hooks[] = {
+  { AST_Node_Case,      rule_case_braces },
+  { AST_Node_Default,   rule_case_braces },
+  { AST_Node_Data_Type, rule_codebase_types },
+  { AST_Node_Function,  rule_internal_functions },
+};
+
+// DOC(fz): Hooks grouped by type, the funcs for type t are funcs[first[t]] up to funcs[first[t + 1]].
+// Fixed size, built once, then only read by every worker.
+typedef struct Rule_Dispatch {
+  b32 is_ready;
+  u32 token_first[Token_Count + 1];
+  rule_token_func* token_funcs[ArrayCount(rule_token_hooks)];
+  u32 node_first[AST_Node_Count + 1];
+  rule_node_func* node_funcs[ArrayCount(rule_node_hooks)];
+} Rule_Dispatch;
+global Rule_Dispatch RuleDispatch;
+
+internal void    rules_init(); /* Builds RuleDispatch. Call before any pass, on one thread */
+internal void    rules_run(Arena* arena, Rule_Context* context, Token_Array* tokens, AST* ast, String8 path); /* tokens may hold only the source, ast may be NULL. Diagnostics go to arena, nothing else may push to it during the pass */
+internal String8 rule_format(Arena* arena, Rule_Code code, String8 argument);
+
+// Help
+internal void      rule_emit(Rule_Context* context, Rule_Code code, u32 start_offset, u32 end_offset, String8 argument);
+internal u64       rule_token_at(Rule_Context* context, u32 offset); /* First token starting at or after offset */
+internal AST_Index rule_child_of_type(AST* ast, AST_Index parent, AST_Node_Type type);
+internal u64       rule_find_word(String8 text, u64 offset, String8 word); /* Next occurrence of word, any case, not inside a longer name. text.size if none */
+
+#endif // RULES_H
@@ -0,0 +1,193 @@
+///////////////
+// Scan
+internal u64 scan_newlines(String8 source, u32* offsets) {
+  u64 count = 0;
+  u64 i     = 0;
+
+#if SCAN_SSE2
+  // NOTE(fz): A '\r' breaks a line unless a '\n' follows, so each block is compared again one byte later. The block
+  // must not end the source, the last byte's follower is read from the next one.
+  __m128i newline = _mm_set1_epi8('\n');
+  __m128i carriage_return = _mm_set1_epi8('\r');
+  for (; i + SCAN_WIDTH < source.size; i += SCAN_WIDTH) {
+    __m128i bytes = _mm_loadu_si128((__m128i*)(source.str + i));
+    __m128i after = _mm_loadu_si128((__m128i*)(source.str + i + 1));
+    __m128i lone  = _mm_andnot_si128(_mm_cmpeq_epi8(after, newline), _mm_cmpeq_epi8(bytes, carriage_return));
+    u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, newline), lone));
+    while (mask) {
+      offsets[count++] = (u32)(i + scan_count_trailing_zeros(mask));
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  for (; i < source.size; i += 1) {
+    char8 c = source.str[i];
+    if (c == '\n' || (c == '\r' && (i + 1 == source.size || source.str[i + 1] != '\n'))) {
+      offsets[count++] = (u32)i;
+    }
+  }
+
+  return count;
+}
+
+internal char8* scan_find_byte(char8* at, char8* end, char8 a) {
+#if SCAN_AVX2
+  __m256i wide_a = _mm256_set1_epi8((char)a);
+  for (; at + SCAN_WIDTH_AVX2 <= end; at += SCAN_WIDTH_AVX2) {
+    __m256i bytes = _mm256_loadu_si256((__m256i*)at);
+    u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, wide_a));
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+#if SCAN_SSE2
+  __m128i vector_a = _mm_set1_epi8((char)a);
+  for (; at + SCAN_WIDTH <= end; at += SCAN_WIDTH) {
+    __m128i bytes = _mm_loadu_si128((__m128i*)at);
+    u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, vector_a));
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+  for (; at < end; at += 1) {
+    if (*at == a) {
+      return at;
+    }
+  }
+  return end;
+}
+
+internal char8* scan_find_either(char8* at, char8* end, char8 a, char8 b) {
+#if SCAN_AVX2
+  __m256i wide_a = _mm256_set1_epi8((char)a);
+  __m256i wide_b = _mm256_set1_epi8((char)b);
+  for (; at + SCAN_WIDTH_AVX2 <= end; at += SCAN_WIDTH_AVX2) {
+    __m256i bytes = _mm256_loadu_si256((__m256i*)at);
+    __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, wide_a), _mm256_cmpeq_epi8(bytes, wide_b));
+    u32 mask = (u32)_mm256_movemask_epi8(match);
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+#if SCAN_SSE2
+  __m128i vector_a = _mm_set1_epi8((char)a);
+  __m128i vector_b = _mm_set1_epi8((char)b);
+  for (; at + SCAN_WIDTH <= end; at += SCAN_WIDTH) {
+    __m128i bytes = _mm_loadu_si128((__m128i*)at);
+    __m128i match = _mm_or_si128(_mm_cmpeq_epi8(bytes, vector_a), _mm_cmpeq_epi8(bytes, vector_b));
+    u32 mask = (u32)_mm_movemask_epi8(match);
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+  for (; at < end; at += 1) {
+    if (*at == a || *at == b) {
+      return at;
+    }
+  }
+  return end;
+}
+
+internal char8* scan_skip_byte(char8* at, char8* end, char8 a) {
+  // NOTE(fz): Indentation runs are usually short, check the first byte before paying for a vector load.
+  if (at < end && *at != a) {
+    return at;
+  }
+
+#if SCAN_AVX2
+  __m256i wide_a = _mm256_set1_epi8((char)a);
+  for (; at + SCAN_WIDTH_AVX2 <= end; at += SCAN_WIDTH_AVX2) {
+    __m256i bytes = _mm256_loadu_si256((__m256i*)at);
+    u32 mask = ~(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, wide_a));
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+#if SCAN_SSE2
+  __m128i vector_a = _mm_set1_epi8((char)a);
+  for (; at + SCAN_WIDTH <= end; at += SCAN_WIDTH) {
+    __m128i bytes = _mm_loadu_si128((__m128i*)at);
+    u32 mask = ~(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, vector_a)) & 0xFFFF;
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+  for (; at < end; at += 1) {
+    if (*at != a) {
+      return at;
+    }
+  }
+  return end;
+}
+
+internal char8* scan_find_whitespace_issue(char8* at, char8* end) {
+  // NOTE(fz): A second load one byte ahead lines every byte up with the one after it, so "space before a line break"
+  // is one AND per vector. The loop stops a byte early, the scalar tail sees the end of the buffer.
+#if SCAN_AVX2
+  __m256i wide_space   = _mm256_set1_epi8(' ');
+  __m256i wide_tab     = _mm256_set1_epi8('\t');
+  __m256i wide_newline = _mm256_set1_epi8('\n');
+  __m256i wide_return  = _mm256_set1_epi8('\r');
+  for (; at + SCAN_WIDTH_AVX2 + 1 <= end; at += SCAN_WIDTH_AVX2) {
+    __m256i bytes = _mm256_loadu_si256((__m256i*)at);
+    __m256i next  = _mm256_loadu_si256((__m256i*)(at + 1));
+    __m256i line_break = _mm256_or_si256(_mm256_cmpeq_epi8(next, wide_newline), _mm256_cmpeq_epi8(next, wide_return));
+    __m256i trailing   = _mm256_and_si256(_mm256_cmpeq_epi8(bytes, wide_space), line_break);
+    u32 mask = (u32)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, wide_tab), trailing));
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+#if SCAN_SSE2
+  __m128i vector_space   = _mm_set1_epi8(' ');
+  __m128i vector_tab     = _mm_set1_epi8('\t');
+  __m128i vector_newline = _mm_set1_epi8('\n');
+  __m128i vector_return  = _mm_set1_epi8('\r');
+  for (; at + SCAN_WIDTH + 1 <= end; at += SCAN_WIDTH) {
+    __m128i bytes = _mm_loadu_si128((__m128i*)at);
+    __m128i next  = _mm_loadu_si128((__m128i*)(at + 1));
+    __m128i line_break = _mm_or_si128(_mm_cmpeq_epi8(next, vector_newline), _mm_cmpeq_epi8(next, vector_return));
+    __m128i trailing   = _mm_and_si128(_mm_cmpeq_epi8(bytes, vector_space), line_break);
+    u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, vector_tab), trailing));
+    if (mask) {
+      return at + scan_count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+  for (; at < end; at += 1) {
+    if (*at == '\t') {
+      return at;
+    }
+    if (*at == ' ' && (at + 1 == end || at[1] == '\n' || at[1] == '\r')) {
+      return at;
+    }
+  }
+  return end;
+}
+
+internal u32 scan_count_trailing_zeros(u32 mask) {
+  Assert(mask != 0);
+#if COMPILER_MSVC
+  unsigned long index = 0;
+  _BitScanForward(&index, mask);
+  return (u32)index;
+#else
+  return (u32)__builtin_ctz(mask);
+#endif
+}
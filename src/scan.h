@@ -0,0 +1,41 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+// DOC(fz): Byte scanning kernels over raw source. Each kernel has an SSE2 path on x86/x64, an AVX2 path when the compiler
+// targets it (/arch:AVX2, -mavx2), and a scalar fallback that gives the same result. AVX2 is opt in: build.sh avx2 or
+// build.bat avx2. The default build runs on any x64 CPU and uses SSE2.
+
+#if ARCH_X64 || ARCH_X86
+# include <emmintrin.h>
+# define SCAN_SSE2 1
+#else
+# define SCAN_SSE2 0
+#endif
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+# define SCAN_AVX2 1
+#else
+# define SCAN_AVX2 0
+#endif
+
+#if COMPILER_MSVC
+# include <intrin.h>
+#endif
+
+#define SCAN_WIDTH      16
+#define SCAN_WIDTH_AVX2 32
+
+internal u64    scan_newlines(String8 source, u32* offsets);              /* Writes the offset of every line break, '\n' or a '\r' not followed by one, into offsets (room for source.size entries) and returns the count */
+internal char8* scan_find_byte(char8* at, char8* end, char8 a);           /* First a in [at, end), or end */
+internal char8* scan_find_either(char8* at, char8* end, char8 a, char8 b); /* First a or b in [at, end), or end */
+internal char8* scan_skip_byte(char8* at, char8* end, char8 a);           /* First byte that is not a in [at, end), or end */
+// NOTE(fz): Space runs are only found where they end a line. Indentation is spaces in this codebase, so "leading spaces"
+// means a line that holds only spaces and tabs: a run that ends the line and also starts it, which rule_whitespace tells
+// apart by walking back from what this returns.
+internal char8* scan_find_whitespace_issue(char8* at, char8* end);       /* First tab, or space right before '\n', '\r' or end, in [at, end), or end */
+
+// Help
+internal u32 scan_count_trailing_zeros(u32 mask);
+
+#endif // SCAN_H
@@ -0,0 +1,266 @@
+///////////////
+// Symbol index
+internal void symbol_index_init(Symbol_Index* index) {
+  MemoryZeroStruct(index);
+  for (u32 i = 0; i < SYMBOL_SHARD_COUNT; i += 1) {
+    Symbol_Shard* shard = &index->shards[i];
+    shard->arena    = arena_init();
+    shard->symbols  = ArenaPush(shard->arena, Symbol, SYMBOL_SHARD_CHUNK_SIZE);
+    shard->capacity = SYMBOL_SHARD_CHUNK_SIZE;
+    shard->count    = 1;
+
+    shard->slots_arena = arena_init();
+    shard->slots_count = SYMBOL_SHARD_CHUNK_SIZE * 2;
+    shard->slots       = ArenaPush(shard->slots_arena, u32, shard->slots_count);
+  }
+}
+
+internal void symbol_index_release(Symbol_Index* index) {
+  for (u32 i = 0; i < SYMBOL_SHARD_COUNT; i += 1) {
+    arena_free(index->shards[i].slots_arena);
+    arena_free(index->shards[i].arena);
+  }
+  MemoryZeroStruct(index);
+}
+
+internal void symbol_index_add(Symbol_Index* index, Intern_Id id, Symbol_Occurrence occurrence) {
+  Symbol_Shard* shard = &index->shards[id & (SYMBOL_SHARD_COUNT - 1)];
+
+  symbol_shard_lock(shard);
+  Symbol* symbol = symbol_shard_get(shard, id);
+  Symbol_Occurrence* copy = ArenaPushNoZero(shard->slots_arena, Symbol_Occurrence, 1);
+  *copy         = occurrence;
+  copy->next    = symbol->first;
+  symbol->first = copy;
+  symbol_shard_unlock(shard);
+}
+
+internal void symbols_collect(Symbol_Index* index, String8 path, Token_Array* tokens, AST* ast) {
+  u32 orders[2] = {0};
+  ASTForEachChild(ast, ast->root, item) {
+    AST_Node_Type type = ASTNode(ast, item)->type;
+    if (type != AST_Node_Function && type != AST_Node_Declaration) continue;
+
+    // int f(void), g(void); declares two functions
+    Symbol_Kind kind = (type == AST_Node_Function) ? Symbol_Kind_Definition : Symbol_Kind_Declaration;
+    ASTForEachChild(ast, item, child) {
+      if (ASTNode(ast, child)->type != AST_Node_Declarator) continue;
+      AST_Index name = symbols_function_name(ast, child);
+      if (name == AST_NULL) continue;
+
+      AST_Node* name_node = ASTNode(ast, name);
+      Token* name_token   = &tokens->tokens[token_index_at(tokens->tokens, tokens->count, name_node->start_offset)];
+      if (name_token->type != Token_Identifier) continue;
+
+      Symbol_Occurrence occurrence = {0};
+      occurrence.kind         = kind;
+      occurrence.path         = path;
+      occurrence.order        = orders[kind];
+      occurrence.start_offset = name_node->start_offset;
+      occurrence.end_offset   = name_node->end_offset;
+      occurrence.position     = text_position_from_offset(&tokens->lines, name_node->start_offset);
+      symbol_index_add(index, name_token->id, occurrence);
+      orders[kind] += 1;
+    }
+  }
+}
+
+internal Symbol_Finding* symbols_check(Arena* arena, Symbol_Index* index, u64* count) {
+  // Findings and pairs are counted first, so both arrays are pushed once
+  u64 findings_count = 0;
+  u64 pairs_count    = 0;
+  for (u32 s = 0; s < SYMBOL_SHARD_COUNT; s += 1) {
+    Symbol_Shard* shard = &index->shards[s];
+    for (u32 i = 1; i < shard->count; i += 1) {
+      b32 is_defined = false;
+      for (Symbol_Occurrence* occurrence = shard->symbols[i].first; occurrence != NULL; occurrence = occurrence->next) {
+        is_defined |= (occurrence->kind == Symbol_Kind_Definition);
+        findings_count += (occurrence->kind == Symbol_Kind_Definition) && file_has_extension(occurrence->path, Str8(".h"));
+        findings_count += 1; // header-order, at most one per occurrence
+        pairs_count    += (occurrence->kind == Symbol_Kind_Definition);
+      }
+      findings_count += !is_defined;
+    }
+  }
+
+  Symbol_Finding* findings = ArenaPushNoZero(arena, Symbol_Finding, findings_count);
+  u64 found = 0;
+  Arena_Temp scratch = scratch_begin(&arena, 1);
+  Symbol_Pair* pairs = ArenaPushNoZero(scratch.arena, Symbol_Pair, pairs_count);
+  u64 paired = 0;
+
+  for (u32 s = 0; s < SYMBOL_SHARD_COUNT; s += 1) {
+    Symbol_Shard* shard = &index->shards[s];
+    for (u32 i = 1; i < shard->count; i += 1) {
+      Symbol* symbol = &shard->symbols[i];
+      // NOTE(fz): Occurrences are listed in whatever order workers added them. Picking by path and offset keeps the report deterministic.
+      Symbol_Occurrence* declaration = NULL;
+      b32 is_defined = false;
+      for (Symbol_Occurrence* occurrence = symbol->first; occurrence != NULL; occurrence = occurrence->next) {
+        if (occurrence->kind == Symbol_Kind_Declaration) {
+          if (declaration == NULL || symbol_occurrence_before(occurrence, declaration)) {
+            declaration = occurrence;
+          }
+          continue;
+        }
+        is_defined = true;
+
+        if (file_has_extension(occurrence->path, Str8(".h"))) {
+          symbol_finding_add(&findings[found++], Rule_Header_Function_Bodies, occurrence, intern_value(symbol->id));
+        }
+
+        Symbol_Occurrence* prototype = NULL;
+        for (Symbol_Occurrence* other = symbol->first; other != NULL; other = other->next) {
+          if (other->kind == Symbol_Kind_Declaration && symbols_is_pair(occurrence->path, other->path) &&
+              (prototype == NULL || other->order < prototype->order)) {
+            prototype = other;
+          }
+        }
+        if (prototype != NULL) {
+          pairs[paired++] = (Symbol_Pair){ occurrence->path, occurrence->order, prototype->order, occurrence, intern_value(symbol->id) };
+        }
+      }
+
+      if (!is_defined && declaration != NULL) {
+        symbol_finding_add(&findings[found++], Rule_Missing_Definition, declaration, intern_value(symbol->id));
+      }
+    }
+  }
+
+  // NOTE(fz): Per X.c, definitions in source order should meet their prototypes in X.h in order too. The ones that do
+  // are a longest run of increasing declaration orders, not necessarily adjacent, and everything outside it moved. A
+  // patience sort finds one run: tails[k] ends the lowest run of length k + 1 seen so far, previous links it back.
+  qsort(pairs, paired, sizeof(Symbol_Pair), symbol_pair_compare);
+  u32* tails    = ArenaPushNoZero(scratch.arena, u32, paired);
+  u32* previous = ArenaPushNoZero(scratch.arena, u32, paired);
+  b8* in_order  = ArenaPush(scratch.arena, b8, paired);
+  for (u64 start = 0, end = 0; start < paired; start = end) {
+    u32 length = 0;
+    for (end = start; end < paired && string8_equal(pairs[end].path, pairs[start].path); end += 1) {
+      u32 order = pairs[end].declaration_order;
+      u32 low   = 0;
+      u32 high  = length;
+      while (low < high) {
+        u32 middle = low + (high - low) / 2;
+        if (pairs[tails[middle]].declaration_order < order) {
+          low = middle + 1;
+        } else {
+          high = middle;
+        }
+      }
+      previous[end] = (low > 0) ? tails[low - 1] : U32_MAX;
+      tails[low]    = (u32)end;
+      length        = Max(length, low + 1);
+    }
+
+    for (u32 i = (length > 0) ? tails[length - 1] : U32_MAX; i != U32_MAX; i = previous[i]) {
+      in_order[i] = true;
+    }
+    for (u64 i = start; i < end; i += 1) {
+      if (!in_order[i]) {
+        symbol_finding_add(&findings[found++], Rule_Header_Order, pairs[i].definition, pairs[i].name);
+      }
+    }
+  }
+  scratch_end(&scratch);
+
+  Assert(found <= findings_count);
+  *count = found;
+  return findings;
+}
+
+///////////////
+// Symbol index help
+internal void symbol_shard_lock(Symbol_Shard* shard) {
+  while (atomic_compare_exchange_u32(&shard->lock, 0, 1) != 0) {
+    while (atomic_load_u32(&shard->lock) != 0) {
+      cpu_pause();
+    }
+  }
+}
+
+internal void symbol_shard_unlock(Symbol_Shard* shard) {
+  atomic_store_u32(&shard->lock, 0);
+}
+
+internal Symbol* symbol_shard_get(Symbol_Shard* shard, Intern_Id id) {
+  u32 mask = shard->slots_count - 1;
+  u32 slot = symbol_slot(id) & mask;
+  while (shard->slots[slot] != 0) {
+    Symbol* symbol = &shard->symbols[shard->slots[slot]];
+    if (symbol->id == id) {
+      return symbol;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  if (shard->count == shard->capacity) {
+    Symbol* chunk = ArenaPush(shard->arena, Symbol, SYMBOL_SHARD_CHUNK_SIZE);
+    Assert(chunk == shard->symbols + shard->capacity);
+    shard->capacity += SYMBOL_SHARD_CHUNK_SIZE;
+  }
+  u32 added = shard->count;
+  Symbol* result = &shard->symbols[added];
+  result->id    = id;
+  result->first = NULL;
+  shard->count += 1;
+  shard->slots[slot] = added;
+
+  // NOTE(fz): Kept at most half full so probing stays short. The old slots stay in the arena, they are small.
+  if (shard->count * 2 > shard->slots_count) {
+    shard->slots_count *= 2;
+    shard->slots = ArenaPush(shard->slots_arena, u32, shard->slots_count);
+    mask = shard->slots_count - 1;
+    for (u32 other = 1; other < shard->count; other += 1) {
+      u32 at = symbol_slot(shard->symbols[other].id) & mask;
+      while (shard->slots[at] != 0) {
+        at = (at + 1) & mask;
+      }
+      shard->slots[at] = other;
+    }
+  }
+  return result;
+}
+
+internal u32 symbol_slot(Intern_Id id) {
+  // The low bits are the same for every id of a shard, the entry index above them is what tells ids apart
+  u32 result = (id >> INTERN_SHARD_BITS) * 2654435761u;
+  return result;
+}
+
+internal AST_Index symbols_function_name(AST* ast, AST_Index declarator) {
+  AST_Index result = ASTNode(ast, declarator)->first_child;
+  if (ASTNode(ast, result)->type != AST_Node_Identifier || rule_child_of_type(ast, declarator, AST_Node_Parameter_List) == AST_NULL) {
+    result = AST_NULL;
+  }
+  return result;
+}
+
+internal b32 symbols_is_pair(String8 definition_path, String8 declaration_path) {
+  u64 size = definition_path.size;
+  b32 result = (size > 2 && declaration_path.size == size) && file_has_extension(definition_path, Str8(".c")) &&
+               file_has_extension(declaration_path, Str8(".h")) && MemoryMatch(definition_path.str, declaration_path.str, size - 1);
+  return result;
+}
+
+internal void symbol_finding_add(Symbol_Finding* finding, Rule_Code code, Symbol_Occurrence* occurrence, String8 name) {
+  finding->path       = occurrence->path;
+  finding->position   = occurrence->position;
+  finding->diagnostic = (Rule_Diagnostic){ code, occurrence->start_offset, occurrence->end_offset, name };
+}
+
+internal b32 symbol_occurrence_before(Symbol_Occurrence* a, Symbol_Occurrence* b) {
+  s32 order  = string8_compare(a->path, b->path);
+  b32 result = (order < 0) || (order == 0 && a->start_offset < b->start_offset);
+  return result;
+}
+
+internal int symbol_pair_compare(const void* a, const void* b) {
+  Symbol_Pair* pair_a = (Symbol_Pair*)a;
+  Symbol_Pair* pair_b = (Symbol_Pair*)b;
+  int result = string8_compare(pair_a->path, pair_b->path);
+  if (result == 0) {
+    result = (pair_a->definition_order > pair_b->definition_order) - (pair_a->definition_order < pair_b->definition_order);
+  }
+  return result;
+}
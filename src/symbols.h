@@ -0,0 +1,87 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+// DOC(fz): Functions of every file in one index, for the rules that need the whole tree: header-order,
+// missing-definition and header-function-bodies. Workers add a file's top level prototypes and definitions right after
+// parsing it, and the rules run once over the index when the pool is done (symbols_check). Names are keyed by their
+// intern id, so nothing here hashes or compares bytes. A name lives in the shard its id's low bits pick (the intern
+// shard, itself picked by hash), and each shard has its own spin lock, so workers only contend when they add to the
+// same shard at the same moment.
+//
+// Nothing compares files pairwise. X.c is matched to X.h by looking each of its definitions up by name, and the order
+// rule sorts what it found per file.
+
+typedef enum Symbol_Kind {
+  Symbol_Kind_Declaration = 0, // Prototype
+  Symbol_Kind_Definition,      // Function with a body
+} Symbol_Kind;
+
+typedef struct Symbol_Occurrence {
+  struct Symbol_Occurrence* next;
+  Symbol_Kind kind;
+  String8 path;     // Of the file, must outlive the index
+  u32 order;        // Among the file's occurrences of the same kind, in source order
+  u32 start_offset; // Of the name
+  u32 end_offset;
+  Text_Position position; // Of start_offset, the file's line index is gone by the time the rules run
+} Symbol_Occurrence;
+
+typedef struct Symbol {
+  Intern_Id id;
+  Symbol_Occurrence* first;
+} Symbol;
+
+typedef struct Symbol_Shard {
+  u32 lock;
+  Arena* arena;     // Holds symbols only, so slots index one contiguous array
+  Symbol* symbols;  // Index 0 is unused
+  u32 count;
+  u32 capacity;
+
+  Arena* slots_arena; // Occurrences and the slots, slots are rebuilt twice as big when half full
+  u32* slots;         // Open addressing on the id, 0 is an empty slot
+  u32 slots_count;
+} Symbol_Shard;
+#define SYMBOL_SHARD_BITS       6
+StaticAssert(SYMBOL_SHARD_BITS <= INTERN_SHARD_BITS, symbol_shard_bits_check); // The shard comes from the hash bits of the id
+#define SYMBOL_SHARD_COUNT      (1 << SYMBOL_SHARD_BITS)
+#define SYMBOL_SHARD_CHUNK_SIZE 256
+
+typedef struct Symbol_Index {
+  Symbol_Shard shards[SYMBOL_SHARD_COUNT];
+} Symbol_Index;
+
+// What the rules found, in no particular order
+typedef struct Symbol_Finding {
+  String8 path;
+  Text_Position position;
+  Rule_Diagnostic diagnostic; // argument points into InternTable
+} Symbol_Finding;
+
+// One definition in X.c matched to its prototype in X.h
+typedef struct Symbol_Pair {
+  String8 path; // X.c
+  u32 definition_order;
+  u32 declaration_order;
+  Symbol_Occurrence* definition;
+  String8 name;
+} Symbol_Pair;
+
+internal void            symbol_index_init(Symbol_Index* index);
+internal void            symbol_index_release(Symbol_Index* index);
+internal void            symbol_index_add(Symbol_Index* index, Intern_Id id, Symbol_Occurrence occurrence); /* Any thread. occurrence is copied, next is ignored */
+internal void            symbols_collect(Symbol_Index* index, String8 path, Token_Array* tokens, AST* ast); /* Every top level function of a parsed file */
+internal Symbol_Finding* symbols_check(Arena* arena, Symbol_Index* index, u64* count); /* Runs the cross file rules, after every file was collected */
+
+// Help
+internal void      symbol_shard_lock(Symbol_Shard* shard);
+internal void      symbol_shard_unlock(Symbol_Shard* shard);
+internal Symbol*   symbol_shard_get(Symbol_Shard* shard, Intern_Id id); /* Adds the name if missing, shard must be locked */
+internal u32       symbol_slot(Intern_Id id);
+internal AST_Index symbols_function_name(AST* ast, AST_Index declarator); /* Identifier naming a function declarator, AST_NULL if it declares no function */
+internal b32       symbols_is_pair(String8 definition_path, String8 declaration_path); /* X.c and X.h */
+internal void      symbol_finding_add(Symbol_Finding* finding, Rule_Code code, Symbol_Occurrence* occurrence, String8 name);
+internal b32       symbol_occurrence_before(Symbol_Occurrence* a, Symbol_Occurrence* b); /* By path, then offset */
+internal int       symbol_pair_compare(const void* a, const void* b);
+
+#endif // SYMBOLS_H